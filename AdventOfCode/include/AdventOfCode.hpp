@@ -5,15 +5,28 @@
 #endif
 
 #include "types.hpp"
-#include "output.hpp"
+#include "input.hpp"
+#include "parse.hpp"
+#include "pattern.hpp"
+#include "exec.hpp"
+#include "arena.hpp"
+#include "memory.hpp"
+#include "counters.hpp"
+#include "trace.hpp"
+#include "Output.hpp"
+#include "problem.hpp"
+#include "profiler.hpp"
 
 #include "rect_map.hpp"
+#include "bit_map.hpp"
 #include "cvector.hpp"
 #include "vec.hpp"
+#include "flat_hash.hpp"
 
 #include <cerrno>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 
 #include <set>
 #include <map>
@@ -25,10 +38,10 @@
 #include <unordered_set>
 #include <unordered_map>
 
-#include <regex>
 #include <atomic>
 #include <string>
 #include <sstream>
+#include <charconv>
 #include <fstream>
 #include <iostream>
 #include <filesystem>
@@ -37,17 +50,10 @@
 #include <limits>
 #include <iomanip>
 #include <numeric>
-#include <execution>
 #include <algorithm>
 
-void init(void);
-void solve(void);
-
 namespace aoc
 {
-  std::string &ProblemName();
-  void register_problem(const char *name);
-
   using u8  = uint8_t;
   using u16 = uint16_t;
   using u32 = uint32_t;
@@ -19,7 +19,9 @@ namespace aoc
 
     void clear()
     {
+      m_ss.str({});
       m_ss.clear();
+      m_width = 0;
       m_lines.clear();
     }
 
@@ -79,7 +81,8 @@ namespace aoc
     LineList m_lines;
   };
 
-  extern "C++" output cout;
+  // one buffer per thread, so problems can be solved concurrently
+  extern "C++" thread_local output cout;
 }
 
 namespace std
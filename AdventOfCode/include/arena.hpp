@@ -0,0 +1,128 @@
+#pragma once
+
+#include <set>
+#include <map>
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+#include <unordered_set>
+#include <unordered_map>
+#include <memory_resource>
+
+namespace aoc
+{
+  // Memory of a single run: allocations are never freed one by one, everything is released at once by reset().
+  // The blocks are kept from one run to the next, once warmed up a run makes no heap call at all
+  class arena : public std::pmr::memory_resource
+  {
+  public:
+    explicit arena(size_t block_size = 1 << 20) : m_block_size(block_size) {}
+    ~arena() override;
+
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    // Releases every allocation. If the last run needed more than one block,
+    // they are merged into a single one large enough for the next run
+    void reset();
+
+    // bytes handed out since the last reset
+    size_t used() const { return m_used; }
+    size_t capacity() const;
+
+  private:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    void add_block(size_t size);
+
+  private:
+    struct block
+    {
+      std::byte *data;
+      size_t     size;
+    };
+
+    std::vector<block> m_blocks;
+    size_t             m_block_size;
+    size_t             m_current = 0; // block being filled
+    size_t             m_offset  = 0; // in the current block
+    size_t             m_used    = 0;
+  };
+
+  // The memory aoc::pmr containers created on this thread allocate from:
+  // the arena of the run in progress, or the heap outside of a run and on the pool workers
+  std::pmr::memory_resource *current_resource();
+
+  // Makes `a` the current resource of this thread for the lifetime of the scope
+  class arena_scope
+  {
+  public:
+    explicit arena_scope(arena &a);
+    ~arena_scope();
+
+    arena_scope(const arena_scope &) = delete;
+    arena_scope &operator=(const arena_scope &) = delete;
+
+  private:
+    std::pmr::memory_resource *m_previous;
+  };
+
+  namespace pmr
+  {
+    // Binds to current_resource() when default constructed, copies of a container bind to it too.
+    // A container must not outlive the run it was created in
+    template<class T>
+    class allocator
+    {
+    public:
+      using value_type = T;
+
+      using propagate_on_container_move_assignment = std::true_type;
+      using propagate_on_container_swap = std::true_type;
+
+    public:
+      allocator() noexcept : m_resource(current_resource()) {}
+      allocator(std::pmr::memory_resource *resource) noexcept : m_resource(resource) {}
+
+      template<class U>
+      allocator(const allocator<U> &other) noexcept : m_resource(other.resource()) {}
+
+      T *allocate(size_t n) { return static_cast<T *>(m_resource->allocate(n * sizeof(T), alignof(T))); }
+      void deallocate(T *p, size_t n) { m_resource->deallocate(p, n * sizeof(T), alignof(T)); }
+
+      allocator select_on_container_copy_construction() const { return allocator(); }
+
+      std::pmr::memory_resource *resource() const { return m_resource; }
+
+      template<class U>
+      bool operator==(const allocator<U> &other) const { return m_resource == other.resource() || m_resource->is_equal(*other.resource()); }
+
+    private:
+      std::pmr::memory_resource *m_resource;
+    };
+
+    template<class T>
+    using vector = std::vector<T, allocator<T>>;
+
+    template<class T>
+    using deque = std::deque<T, allocator<T>>;
+
+    template<class T, class Compare = std::less<T>>
+    using set = std::set<T, Compare, allocator<T>>;
+
+    template<class K, class V, class Compare = std::less<K>>
+    using map = std::map<K, V, Compare, allocator<std::pair<const K, V>>>;
+
+    template<class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>>
+    using unordered_set = std::unordered_set<T, Hash, Equal, allocator<T>>;
+
+    template<class K, class V, class Hash = std::hash<K>, class Equal = std::equal_to<K>>
+    using unordered_map = std::unordered_map<K, V, Hash, Equal, allocator<std::pair<const K, V>>>;
+
+    using string = std::basic_string<char, std::char_traits<char>, allocator<char>>;
+  }
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "vec.hpp"
+
+#include <bit>
+#include <span>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+namespace aoc
+{
+  // A grid of bits, indexed like rect_map: 64 cells per word, for visited and occupancy masks.
+  //
+  // Each row starts on a word of its own, cell x of a row being bit x % 64 of its word x / 64.
+  // The bits past the width of a row are always clear, so counts and whole-row operations need no masking.
+  class bit_map
+  {
+  public:
+    using word = uint64_t;
+    static constexpr size_t word_bits = 64;
+
+  public:
+    bit_map() = default;
+    bit_map(size_t width, size_t height, bool v = false)
+      : m_size(width, height), m_stride((width + word_bits - 1) / word_bits), m_data(m_stride * height, 0)
+    {
+      if (v)
+        fill(true);
+    }
+    explicit bit_map(vec2s size, bool v = false) : bit_map(size.w, size.h, v) {}
+
+    vec2s size() const { return m_size; }
+    size_t width() const { return m_size.w; }
+    size_t height() const { return m_size.h; }
+
+    // words per row
+    size_t stride() const { return m_stride; }
+
+    word *data() { return m_data.data(); }
+    const word *data() const { return m_data.data(); }
+
+    std::span<word> row(size_t y) { return { m_data.data() + y * m_stride, m_stride }; }
+    std::span<const word> row(size_t y) const { return { m_data.data() + y * m_stride, m_stride }; }
+
+    template<class U>
+    requires std::is_integral_v<U>
+    bool contains(vec<2, U> pos) const { return pos.x >= 0 && pos.x < m_size.w && pos.y >= 0 && pos.y < m_size.h; }
+
+    template<class U>
+    requires std::is_integral_v<U>
+    bool operator[](vec<2, U> pos) const { return test(pos); }
+
+    template<class U>
+    requires std::is_integral_v<U>
+    bool test(vec<2, U> pos) const { return (word_at(pos) >> bit_of(pos)) & 1; }
+
+    template<class U>
+    requires std::is_integral_v<U>
+    void set(vec<2, U> pos, bool v = true)
+    {
+      if (v)
+        word_at(pos) |= word(1) << bit_of(pos);
+      else
+        reset(pos);
+    }
+
+    template<class U>
+    requires std::is_integral_v<U>
+    void reset(vec<2, U> pos) { word_at(pos) &= ~(word(1) << bit_of(pos)); }
+
+    // Sets the cell, returns whether it was clear: `if (visited.insert(pos))` like a set
+    template<class U>
+    requires std::is_integral_v<U>
+    bool insert(vec<2, U> pos)
+    {
+      word &w = word_at(pos);
+      const word bit = word(1) << bit_of(pos);
+      const bool inserted = !(w & bit);
+      w |= bit;
+      return inserted;
+    }
+
+    void fill(bool v)
+    {
+      std::fill(m_data.begin(), m_data.end(), v ? ~word(0) : word(0));
+      if (v)
+        clear_padding();
+    }
+
+    void clear() { fill(false); }
+
+    // Number of set cells
+    size_t count() const
+    {
+      size_t total = 0;
+      for (const word w : m_data)
+        total += size_t(std::popcount(w));
+      return total;
+    }
+
+    size_t count_row(size_t y) const
+    {
+      size_t total = 0;
+      for (const word w : row(y))
+        total += size_t(std::popcount(w));
+      return total;
+    }
+
+    // Moves the cells of a row `n` cells towards x = 0, the cells leaving the row are dropped
+    void shift_row_left(size_t y, size_t n)
+    {
+      const std::span<word> words = row(y);
+      const size_t skip = n / word_bits;
+      const size_t bits = n % word_bits;
+
+      for (size_t i = 0; i < words.size(); ++i)
+      {
+        const word low = (i + skip < words.size()) ? words[i + skip] : 0;
+        const word high = (i + skip + 1 < words.size()) ? words[i + skip + 1] : 0;
+        words[i] = bits ? (low >> bits) | (high << (word_bits - bits)) : low;
+      }
+    }
+
+    // Moves the cells of a row `n` cells towards x = width, the cells leaving the row are dropped
+    void shift_row_right(size_t y, size_t n)
+    {
+      const std::span<word> words = row(y);
+      const size_t skip = n / word_bits;
+      const size_t bits = n % word_bits;
+
+      for (size_t i = words.size(); i-- > 0;)
+      {
+        const word high = (i >= skip) ? words[i - skip] : 0;
+        const word low = (i >= skip + 1) ? words[i - skip - 1] : 0;
+        words[i] = bits ? (high << bits) | (low >> (word_bits - bits)) : high;
+      }
+      clear_padding(y);
+    }
+
+    // Combine row `y` with `other`, a row of a map of the same width (this one included)
+    void and_row(size_t y, std::span<const word> other) { combine_row(y, other, [](word a, word b) { return a & b; }); }
+    void or_row(size_t y, std::span<const word> other) { combine_row(y, other, [](word a, word b) { return a | b; }); }
+    void xor_row(size_t y, std::span<const word> other) { combine_row(y, other, [](word a, word b) { return a ^ b; }); }
+    void andnot_row(size_t y, std::span<const word> other) { combine_row(y, other, [](word a, word b) { return a & ~b; }); }
+
+    // Whole maps of the same size
+    bit_map &operator&=(const bit_map &other) { return combine(other, [](word a, word b) { return a & b; }); }
+    bit_map &operator|=(const bit_map &other) { return combine(other, [](word a, word b) { return a | b; }); }
+    bit_map &operator^=(const bit_map &other) { return combine(other, [](word a, word b) { return a ^ b; }); }
+
+    void flip()
+    {
+      for (word &w : m_data)
+        w = ~w;
+      clear_padding();
+    }
+
+    bool operator==(const bit_map &) const = default;
+
+  private:
+    template<class U>
+    word &word_at(vec<2, U> pos) { return m_data[size_t(pos.y) * m_stride + size_t(pos.x) / word_bits]; }
+    template<class U>
+    const word &word_at(vec<2, U> pos) const { return m_data[size_t(pos.y) * m_stride + size_t(pos.x) / word_bits]; }
+
+    template<class U>
+    static size_t bit_of(vec<2, U> pos) { return size_t(pos.x) % word_bits; }
+
+    // the cells of the last word of a row that are within the width
+    word last_mask() const
+    {
+      const size_t bits = m_size.w % word_bits;
+      return bits ? (word(1) << bits) - 1 : ~word(0);
+    }
+
+    void clear_padding(size_t y)
+    {
+      if (m_stride)
+        m_data[y * m_stride + m_stride - 1] &= last_mask();
+    }
+
+    void clear_padding()
+    {
+      for (size_t y = 0; y < m_size.h; ++y)
+        clear_padding(y);
+    }
+
+    template<class Op>
+    void combine_row(size_t y, std::span<const word> other, Op op)
+    {
+      assert(other.size() == m_stride);
+
+      const std::span<word> words = row(y);
+      for (size_t i = 0; i < words.size(); ++i)
+        words[i] = op(words[i], other[i]);
+      clear_padding(y);
+    }
+
+    template<class Op>
+    bit_map &combine(const bit_map &other, Op op)
+    {
+      assert(other.m_size == m_size);
+
+      for (size_t i = 0; i < m_data.size(); ++i)
+        m_data[i] = op(m_data[i], other.m_data[i]);
+      return *this;
+    }
+
+  private:
+    vec2s m_size = { 0, 0 };
+    size_t m_stride = 0;
+    std::vector<word> m_data;
+  };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+
+// Answers kept on disk, addressed by the content of their input.
+//
+// An entry is named after a 128-bit hash of the input bytes, seeded with the problem and the build:
+// a rebuilt solver never reads the answers of the previous one
+namespace aoc::cache
+{
+  struct key
+  {
+    uint64_t low  = 0;
+    uint64_t high = 0;
+
+    // 32 hexadecimal digits, the name of the entry
+    std::string hex() const;
+
+    bool operator==(const key &) const = default;
+  };
+
+  // Fast and non-cryptographic: it tells inputs apart, it does not resist inputs crafted to collide
+  key hash(std::string_view bytes, uint64_t seed = 0);
+
+  // Hash of the running executable, computed on first use
+  const std::string &build_id();
+
+  // Key of the answers of the problem `name` on `input`
+  key entry_key(std::string_view name, std::string_view input);
+
+  // The answers stored in `directory` under `k`, if any
+  std::optional<std::vector<std::string>> load(const std::filesystem::path &directory, const key &k);
+
+  // Replaces the entry as a whole: concurrent readers see either the old answers or the new ones
+  void save(const std::filesystem::path &directory, const key &k, const std::vector<std::string> &answers);
+}
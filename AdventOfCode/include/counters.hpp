@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Hardware performance counters of the calling thread, read through perf_event_open on Linux.
+//
+// The counters are opened on a thread the first time it reads them, as a single group so they all cover
+// the same instructions. When the kernel refuses (no PMU in a virtual machine, perf_event_paranoid...)
+// or on other systems, reads return an empty sample and error() tells why.
+namespace aoc::perf
+{
+  enum event : size_t
+  {
+    cycles,
+    instructions,
+    cache_misses,
+    branch_misses,
+
+    event_count
+  };
+
+  constexpr const char *event_names[event_count] = { "cycles", "instructions", "cache misses", "branch misses" };
+
+  struct sample
+  {
+    std::array<uint64_t, event_count> values = {};
+    uint32_t available = 0; // bit i is set when event i was counted
+
+    bool has(event e) const { return available >> e & 1; }
+    bool empty() const { return available == 0; }
+
+    // instructions per cycle, 0 if either is missing
+    double ipc() const
+    {
+      if (!has(cycles) || !has(instructions) || values[cycles] == 0)
+        return 0;
+      return double(values[instructions]) / double(values[cycles]);
+    }
+
+    // counts between `start` and this sample
+    sample operator-(const sample &start) const
+    {
+      sample result;
+      result.available = available & start.available;
+      for (size_t i = 0; i < event_count; ++i)
+        result.values[i] = values[i] - start.values[i];
+      return result;
+    }
+
+    sample &operator+=(const sample &other)
+    {
+      available = empty() ? other.available : (available & other.available);
+      for (size_t i = 0; i < event_count; ++i)
+        values[i] += other.values[i];
+      return *this;
+    }
+  };
+
+  // Counters are only read once enabled, the runner enables them with --counters
+  void enable();
+  bool enabled();
+
+  // Current counts of this thread, empty if disabled or unavailable
+  sample read();
+
+  // Why the counters of this thread are unavailable, empty if they are not
+  std::string error();
+}
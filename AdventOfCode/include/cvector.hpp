@@ -3,6 +3,7 @@
 #include "types.hpp"
 
 #include <cassert>
+#include <cstring>
 
 namespace aoc
 {
@@ -49,7 +50,7 @@ namespace aoc
     void clear()
     {
       for (size_t i = 0; i < m_size; ++i)
-        m_data[i].~T();
+        data()[i].~T();
       m_size = 0;
     }
 
@@ -58,7 +59,7 @@ namespace aoc
       assert(m_size < Capacity);
 
       if (m_size < Capacity)
-        new (m_data + m_size++) T(value);
+        new (data() + m_size++) T(value);
     }
 
     template<class... Args>
@@ -92,7 +93,7 @@ namespace aoc
     const_iterator end() const { return data() + m_size; }
 
   private:
-    u8 m_data[Capacity * sizeof(T)];
+    alignas(T) u8 m_data[Capacity * sizeof(T)];
     size_t m_size = 0;
   };
 
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <iterator>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+// Parallel algorithms running on a work-stealing thread pool.
+//
+// The range is cut in chunks that the calling thread and the pool workers claim one at a time,
+// so a slow chunk never holds back the others. The calling thread always takes part:
+// nested calls, or a busy pool, can't deadlock.
+// With SINGLE_THREADED defined, everything runs inline on the calling thread.
+namespace aoc::exec
+{
+  using task = std::function<void()>;
+
+  // Threads with their own task deque. A worker takes its newest task first,
+  // and steals the oldest task of another worker when its own deque is empty
+  class pool
+  {
+  public:
+    explicit pool(unsigned workers);
+    ~pool();
+
+    pool(const pool &) = delete;
+    pool &operator=(const pool &) = delete;
+
+    unsigned size() const { return unsigned(m_workers.size()); }
+
+    void submit(task t);
+
+  private:
+    struct worker
+    {
+      std::mutex        mutex;
+      std::deque<task>  tasks;
+      std::thread       thread;
+    };
+
+    bool pop(size_t index, task &t);
+    void run(size_t index);
+
+  private:
+    std::vector<std::unique_ptr<worker>> m_workers;
+    std::atomic<size_t>                  m_next = 0; // round robin for tasks submitted from outside the pool
+
+    std::mutex              m_mutex;
+    std::condition_variable m_wakeup;
+    std::atomic<long>       m_pending = 0;
+    bool                    m_stop = false;
+  };
+
+  // Accumulators written by different threads are kept on different cache lines
+  constexpr size_t cache_line = 64;
+
+  template<class T>
+  struct alignas(cache_line) padded
+  {
+    T value;
+  };
+
+  // Number of threads the algorithms use, the calling thread included
+  unsigned threads();
+
+  // 0 means one thread per core. Must not be called while an algorithm is running
+  void set_threads(unsigned count);
+
+  // To call first in a child process made by fork(): the pool of the parent is dropped without joining its threads,
+  // which were not copied into the child, and its lock is made anew since another thread may have held it
+  void after_fork();
+
+  namespace detail
+  {
+    // Calls fn(chunk) for every chunk in [0, count) on up to `max_threads` threads (0: all of them).
+    // The first exception thrown by `fn` is rethrown once every chunk is done
+    void run_chunks(size_t count, const std::function<void(size_t)> &fn, unsigned max_threads = 0);
+
+    // Enough chunks to balance the load, not so many that claiming them costs more than running them
+    inline size_t chunk_count(size_t size, size_t grain)
+    {
+      if (size == 0)
+        return 0;
+
+      const size_t max_chunks = size_t(threads()) * 8;
+      const size_t chunks = grain ? (size + grain - 1) / grain : max_chunks;
+      return std::min(std::max<size_t>(chunks, 1), size);
+    }
+  }
+
+  // Calls fn(i) for every i in [begin, end).
+  // `grain` is the number of indices per chunk (0: automatic), at most `max_threads` run at once (0: no limit)
+  template<class Index, class Fn>
+  void parallel_for(Index begin, Index end, Fn &&fn, size_t grain = 0, unsigned max_threads = 0)
+  {
+    if (end <= begin)
+      return;
+
+    const size_t size = size_t(end - begin);
+    const size_t chunks = detail::chunk_count(size, grain);
+
+    detail::run_chunks(chunks, [&](size_t chunk)
+    {
+      const Index first = begin + Index(size * chunk / chunks);
+      const Index last  = begin + Index(size * (chunk + 1) / chunks);
+
+      for (Index i = first; i < last; ++i)
+        fn(i);
+    }, max_threads);
+  }
+
+  // Calls fn(*it) for every element of [first, last)
+  template<std::random_access_iterator It, class Fn>
+  void for_each(It first, It last, Fn &&fn)
+  {
+    parallel_for(std::iter_difference_t<It>(0), last - first, [&](auto i) { fn(first[i]); });
+  }
+
+  // out[i] = fn(first[i]) for every element of [first, last)
+  template<std::random_access_iterator It, std::random_access_iterator Out, class Fn>
+  Out transform(It first, It last, Out out, Fn &&fn)
+  {
+    parallel_for(std::iter_difference_t<It>(0), last - first, [&](auto i) { out[i] = fn(first[i]); });
+    return out + (last - first);
+  }
+
+  // reduce(init, transform(x)...) over [first, last).
+  // Each chunk is reduced on its own, the partial results are combined in chunk order
+  template<std::random_access_iterator It, class T, class Reduce, class Transform>
+  T transform_reduce(It first, It last, T init, Reduce reduce, Transform transform)
+  {
+    if (last <= first)
+      return init;
+
+    const size_t size = size_t(last - first);
+    const size_t chunks = detail::chunk_count(size, 0);
+
+    std::vector<padded<std::optional<T>>> partials(chunks);
+
+    detail::run_chunks(chunks, [&](size_t chunk)
+    {
+      It it = first + (size * chunk / chunks);
+      const It end = first + (size * (chunk + 1) / chunks);
+
+      T partial = transform(*it);
+      while (++it < end)
+        partial = reduce(std::move(partial), transform(*it));
+      partials[chunk].value = std::move(partial);
+    });
+
+    for (padded<std::optional<T>> &partial : partials)
+      init = reduce(std::move(init), std::move(*partial.value));
+    return init;
+  }
+
+  // Reduces [begin, end) without sharing an accumulator between threads.
+  // Each chunk starts from a copy of `identity` and calls accumulate(acc, i) for its indices,
+  // the accumulators are then folded in chunk order with combine(result, acc).
+  // Which thread ran which chunk never changes the result
+  template<class Index, class T, class Accumulate, class Combine>
+  T parallel_reduce(Index begin, Index end, const T &identity, Accumulate &&accumulate, Combine &&combine)
+  {
+    if (end <= begin)
+      return identity;
+
+    const size_t size = size_t(end - begin);
+    const size_t chunks = detail::chunk_count(size, 0);
+
+    std::vector<padded<T>> partials(chunks, padded<T>{ identity });
+
+    detail::run_chunks(chunks, [&](size_t chunk)
+    {
+      const Index first = begin + Index(size * chunk / chunks);
+      const Index last  = begin + Index(size * (chunk + 1) / chunks);
+
+      T &acc = partials[chunk].value;
+      for (Index i = first; i < last; ++i)
+        accumulate(acc, i);
+    });
+
+    T result = std::move(partials[0].value);
+    for (size_t i = 1; i < chunks; ++i)
+      combine(result, partials[i].value);
+    return result;
+  }
+
+  // Sum of transform(x) over [first, last)
+  template<std::random_access_iterator It, class Transform>
+  auto sum(It first, It last, Transform &&transform)
+  {
+    using T = std::decay_t<decltype(transform(*first))>;
+
+    return parallel_reduce(
+      std::iter_difference_t<It>(0), last - first,
+      T(),
+      [&](T &acc, auto i) { acc += transform(first[i]); },
+      [](T &result, const T &partial) { result += partial; }
+    );
+  }
+
+  // Number of elements of [first, last) in each of the N buckets.
+  // bucket(x) returns the index of the bucket of x, elements with an index of N or more are not counted
+  template<size_t N, std::random_access_iterator It, class Bucket>
+  std::array<size_t, N> histogram(It first, It last, Bucket &&bucket)
+  {
+    using counts = std::array<size_t, N>;
+
+    return parallel_reduce(
+      std::iter_difference_t<It>(0), last - first,
+      counts{},
+      [&](counts &acc, auto i)
+      {
+        const size_t index = size_t(bucket(first[i]));
+        if (index < N)
+          ++acc[index];
+      },
+      [](counts &result, const counts &partial)
+      {
+        for (size_t i = 0; i < N; ++i)
+          result[i] += partial[i];
+      }
+    );
+  }
+
+  // Smallest and largest key(x) of a non empty [first, last)
+  template<std::random_access_iterator It, class Key>
+  auto minmax(It first, It last, Key &&key)
+  {
+    using T = std::decay_t<decltype(key(*first))>;
+    using bounds = std::pair<T, T>;
+
+    const T init = key(*first);
+    return parallel_reduce(
+      std::iter_difference_t<It>(0), last - first,
+      bounds(init, init),
+      [&](bounds &acc, auto i)
+      {
+        const T value = key(first[i]);
+        if (value < acc.first)
+          acc.first = value;
+        if (acc.second < value)
+          acc.second = value;
+      },
+      [](bounds &result, const bounds &partial)
+      {
+        if (partial.first < result.first)
+          result.first = partial.first;
+        if (result.second < partial.second)
+          result.second = partial.second;
+      }
+    );
+  }
+}
@@ -0,0 +1,572 @@
+#pragma once
+
+#include "vec.hpp"
+#include "arena.hpp"
+
+#include <bit>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+// Control bytes are matched 16 at a time with SSE2, byte per byte otherwise
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define AOC_FLAT_SSE2
+#endif
+
+// Open addressing hash containers, in the manner of Swiss tables.
+//
+// Every slot has a control byte: the 7 low bits of its hash when full, a marker with the high bit set otherwise.
+// Lookups probe groups of 16 slots, comparing the 16 control bytes with the wanted bits at once,
+// and only compare the keys of the slots matching them. Values live in a single array: no allocation per insert.
+// The hash given by `Hash` is mixed again, so weak hashes (the identity of a pointer) spread as well.
+// Inserting or erasing invalidates the iterators, rehashing moves the values.
+namespace aoc
+{
+  namespace detail
+  {
+    constexpr i8     ctrl_empty   = -128;
+    constexpr i8     ctrl_deleted = -2;
+    constexpr size_t group_size   = 16;
+
+    // Bit i of a match is set for slot i of the group
+    class ctrl_group
+    {
+    public:
+      explicit ctrl_group(const i8 *ctrl)
+      {
+#if defined(AOC_FLAT_SSE2)
+        m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+#else
+        std::memcpy(m_ctrl, ctrl, group_size);
+#endif
+      }
+
+      uint32_t match(i8 h2) const
+      {
+#if defined(AOC_FLAT_SSE2)
+        return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(m_ctrl, _mm_set1_epi8(h2))));
+#else
+        uint32_t bits = 0;
+        for (size_t i = 0; i < group_size; ++i)
+          bits |= uint32_t(m_ctrl[i] == h2) << i;
+        return bits;
+#endif
+      }
+
+      uint32_t match_empty() const { return match(ctrl_empty); }
+
+      // empty or deleted: the only control bytes with their high bit set
+      uint32_t match_free() const
+      {
+#if defined(AOC_FLAT_SSE2)
+        return uint32_t(_mm_movemask_epi8(m_ctrl));
+#else
+        uint32_t bits = 0;
+        for (size_t i = 0; i < group_size; ++i)
+          bits |= uint32_t(m_ctrl[i] < 0) << i;
+        return bits;
+#endif
+      }
+
+    private:
+#if defined(AOC_FLAT_SSE2)
+      __m128i m_ctrl;
+#else
+      i8 m_ctrl[group_size];
+#endif
+    };
+
+    struct set_key
+    {
+      template<class T>
+      const T &operator()(const T &value) const { return value; }
+    };
+
+    struct map_key
+    {
+      template<class Pair>
+      const typename Pair::first_type &operator()(const Pair &value) const { return value.first; }
+    };
+
+    // The table shared by flat_set and flat_map, `KeyOf` extracts the key of a value
+    template<class Key, class Value, class KeyOf, class Hash, class Equal, class Alloc>
+    class flat_table
+    {
+      using value_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Value>;
+      using ctrl_alloc  = typename std::allocator_traits<Alloc>::template rebind_alloc<i8>;
+      using value_traits = std::allocator_traits<value_alloc>;
+      using ctrl_traits  = std::allocator_traits<ctrl_alloc>;
+
+    public:
+      using key_type        = Key;
+      using value_type      = Value;
+      using size_type       = size_t;
+      using difference_type = std::ptrdiff_t;
+      using hasher          = Hash;
+      using key_equal       = Equal;
+      using allocator_type  = Alloc;
+      using reference       = value_type &;
+      using const_reference = const value_type &;
+
+      template<bool Const>
+      class basic_iterator
+      {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Value;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<Const, const Value *, Value *>;
+        using reference         = std::conditional_t<Const, const Value &, Value &>;
+
+      public:
+        basic_iterator() = default;
+        basic_iterator(const i8 *ctrl, const i8 *end, pointer slot) : m_ctrl(ctrl), m_end(end), m_slot(slot) {}
+
+        template<bool OtherConst> requires (Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst> &other) : m_ctrl(other.m_ctrl), m_end(other.m_end), m_slot(other.m_slot) {}
+
+        reference operator*() const { return *m_slot; }
+        pointer operator->() const { return m_slot; }
+
+        basic_iterator &operator++()
+        {
+          ++m_ctrl;
+          ++m_slot;
+          skip_free();
+          return *this;
+        }
+        basic_iterator operator++(int) { basic_iterator tmp = *this; ++*this; return tmp; }
+
+        template<bool OtherConst>
+        bool operator==(const basic_iterator<OtherConst> &other) const { return m_ctrl == other.m_ctrl; }
+
+      private:
+        template<bool> friend class basic_iterator;
+        friend class flat_table;
+
+        void skip_free()
+        {
+          while (m_ctrl != m_end && *m_ctrl < 0)
+          {
+            ++m_ctrl;
+            ++m_slot;
+          }
+        }
+
+      private:
+        const i8 *m_ctrl = nullptr;
+        const i8 *m_end  = nullptr;
+        pointer   m_slot = nullptr;
+      };
+
+      using iterator       = basic_iterator<false>;
+      using const_iterator = basic_iterator<true>;
+
+    public:
+      flat_table() = default;
+      explicit flat_table(const Alloc &alloc) : m_alloc(alloc) {}
+
+      template<class It>
+      flat_table(It first, It last, const Alloc &alloc = Alloc()) : m_alloc(alloc)
+      {
+        insert(first, last);
+      }
+
+      flat_table(const flat_table &other)
+        : m_hash(other.m_hash), m_equal(other.m_equal),
+          m_alloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_alloc))
+      {
+        reserve(other.m_size);
+        for (const value_type &value : other)
+          insert_unique(value);
+      }
+
+      flat_table(flat_table &&other) noexcept
+        : m_ctrl(std::exchange(other.m_ctrl, nullptr)),
+          m_slots(std::exchange(other.m_slots, nullptr)),
+          m_capacity(std::exchange(other.m_capacity, 0)),
+          m_size(std::exchange(other.m_size, 0)),
+          m_growth_left(std::exchange(other.m_growth_left, 0)),
+          m_hash(other.m_hash), m_equal(other.m_equal), m_alloc(other.m_alloc)
+      {}
+
+      flat_table &operator=(flat_table other) noexcept
+      {
+        swap(other);
+        return *this;
+      }
+
+      ~flat_table()
+      {
+        release();
+      }
+
+      void swap(flat_table &other) noexcept
+      {
+        using std::swap;
+        swap(m_ctrl, other.m_ctrl);
+        swap(m_slots, other.m_slots);
+        swap(m_capacity, other.m_capacity);
+        swap(m_size, other.m_size);
+        swap(m_growth_left, other.m_growth_left);
+        swap(m_hash, other.m_hash);
+        swap(m_equal, other.m_equal);
+        swap(m_alloc, other.m_alloc);
+      }
+
+      iterator begin() { iterator it(m_ctrl, m_ctrl + m_capacity, m_slots); it.skip_free(); return it; }
+      iterator end() { return iterator(m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity); }
+      const_iterator begin() const { const_iterator it(m_ctrl, m_ctrl + m_capacity, m_slots); it.skip_free(); return it; }
+      const_iterator end() const { return const_iterator(m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity); }
+
+      size_type size() const { return m_size; }
+      bool empty() const { return m_size == 0; }
+      size_type capacity() const { return m_capacity; }
+      allocator_type get_allocator() const { return m_alloc; }
+
+      iterator find(const key_type &key)
+      {
+        const size_t index = find_index(key, hash_of(key));
+        return (index == npos) ? end() : iterator_at(index);
+      }
+
+      const_iterator find(const key_type &key) const
+      {
+        const size_t index = find_index(key, hash_of(key));
+        return (index == npos) ? end() : const_iterator(iterator_at(index));
+      }
+
+      bool contains(const key_type &key) const { return find_index(key, hash_of(key)) != npos; }
+      size_type count(const key_type &key) const { return contains(key) ? 1 : 0; }
+
+      std::pair<iterator, bool> insert(const value_type &value) { return emplace_key(KeyOf()(value), value); }
+      std::pair<iterator, bool> insert(value_type &&value) { return emplace_key(KeyOf()(value), std::move(value)); }
+
+      template<class It>
+      void insert(It first, It last)
+      {
+        for (; first != last; ++first)
+          insert(*first);
+      }
+
+      void insert(std::initializer_list<value_type> list) { insert(list.begin(), list.end()); }
+
+      template<class... Args>
+      std::pair<iterator, bool> emplace(Args &&...args)
+      {
+        value_type value(std::forward<Args>(args)...);
+        return insert(std::move(value));
+      }
+
+      size_type erase(const key_type &key)
+      {
+        const size_t index = find_index(key, hash_of(key));
+        if (index == npos)
+          return 0;
+
+        erase_at(index);
+        return 1;
+      }
+
+      iterator erase(const_iterator pos)
+      {
+        const size_t index = size_t(pos.m_ctrl - m_ctrl);
+        erase_at(index);
+
+        iterator next = iterator_at(index);
+        next.skip_free();
+        return next;
+      }
+
+      void clear()
+      {
+        destroy_values();
+        if (m_capacity)
+          std::memset(m_ctrl, ctrl_empty, m_capacity);
+        m_size = 0;
+        m_growth_left = max_load(m_capacity);
+      }
+
+      // Room for `count` values without rehashing
+      void reserve(size_type count)
+      {
+        if (count > m_size + m_growth_left)
+          resize(capacity_for(count));
+      }
+
+    protected:
+      static constexpr size_t npos = size_t(-1);
+
+      // the mix spreads the low bits of weak hashes to the high bits picking the group, and back
+      size_t hash_of(const key_type &key) const { return size_t(hash_mix(u64(m_hash(key)))); }
+
+      static i8 h2(size_t hash) { return i8(hash & 0x7F); }
+
+      iterator iterator_at(size_t index) const
+      {
+        return iterator(m_ctrl + index, m_ctrl + m_capacity, m_slots + index);
+      }
+
+      size_t find_index(const key_type &key, size_t hash) const
+      {
+        if (m_capacity == 0)
+          return npos;
+
+        const size_t mask = m_capacity / group_size - 1;
+        size_t group = (hash >> 7) & mask;
+
+        // triangular probing visits every group once, their count being a power of 2
+        for (size_t step = 1;; ++step)
+        {
+          const ctrl_group ctrl(m_ctrl + group * group_size);
+
+          for (uint32_t bits = ctrl.match(h2(hash)); bits; bits &= bits - 1)
+          {
+            const size_t index = group * group_size + size_t(std::countr_zero(bits));
+            if (m_equal(KeyOf()(m_slots[index]), key))
+              return index;
+          }
+
+          // the key would have been inserted here
+          if (ctrl.match_empty())
+            return npos;
+
+          group = (group + step) & mask;
+        }
+      }
+
+      // First empty or deleted slot on the probe sequence of `hash`, there is always one
+      size_t find_free(size_t hash) const
+      {
+        const size_t mask = m_capacity / group_size - 1;
+        size_t group = (hash >> 7) & mask;
+
+        for (size_t step = 1;; ++step)
+        {
+          const uint32_t bits = ctrl_group(m_ctrl + group * group_size).match_free();
+          if (bits)
+            return group * group_size + size_t(std::countr_zero(bits));
+
+          group = (group + step) & mask;
+        }
+      }
+
+      template<class... Args>
+      std::pair<iterator, bool> emplace_key(const key_type &key, Args &&...args)
+      {
+        const size_t hash = hash_of(key);
+
+        const size_t found = find_index(key, hash);
+        if (found != npos)
+          return { iterator_at(found), false };
+
+        return { iterator_at(insert_new(hash, std::forward<Args>(args)...)), true };
+      }
+
+      // The key is known to be absent
+      template<class... Args>
+      size_t insert_new(size_t hash, Args &&...args)
+      {
+        if (m_growth_left == 0)
+          grow();
+
+        value_alloc values(m_alloc);
+        const size_t index = find_free(hash);
+        value_traits::construct(values, m_slots + index, std::forward<Args>(args)...);
+
+        // a deleted slot was already counted as used
+        if (m_ctrl[index] == ctrl_empty)
+          --m_growth_left;
+        m_ctrl[index] = h2(hash);
+        ++m_size;
+        return index;
+      }
+
+      void insert_unique(const value_type &value)
+      {
+        insert_new(hash_of(KeyOf()(value)), value);
+      }
+
+    private:
+      // 7/8 of the slots at most are used, full or deleted
+      static size_t max_load(size_t capacity) { return capacity - capacity / 8; }
+
+      static size_t capacity_for(size_t count)
+      {
+        size_t capacity = group_size;
+        while (max_load(capacity) < count)
+          capacity *= 2;
+        return capacity;
+      }
+
+      void erase_at(size_t index)
+      {
+        value_alloc values(m_alloc);
+        value_traits::destroy(values, m_slots + index);
+        m_ctrl[index] = ctrl_deleted;
+        --m_size;
+      }
+
+      // Doubles the table, or only drops the deleted slots when they take most of the room
+      void grow()
+      {
+        if (m_capacity && m_size < max_load(m_capacity) / 2)
+          resize(m_capacity);
+        else
+          resize(m_capacity ? m_capacity * 2 : group_size);
+      }
+
+      void resize(size_t capacity)
+      {
+        value_alloc values(m_alloc);
+        ctrl_alloc ctrls(m_alloc);
+
+        i8 *old_ctrl = m_ctrl;
+        value_type *old_slots = m_slots;
+        const size_t old_capacity = m_capacity;
+
+        m_ctrl = ctrl_traits::allocate(ctrls, capacity);
+        m_slots = value_traits::allocate(values, capacity);
+        m_capacity = capacity;
+        std::memset(m_ctrl, ctrl_empty, capacity);
+
+        for (size_t i = 0; i < old_capacity; ++i)
+        {
+          if (old_ctrl[i] < 0)
+            continue;
+
+          const size_t hash = hash_of(KeyOf()(old_slots[i]));
+          const size_t index = find_free(hash);
+          value_traits::construct(values, m_slots + index, std::move(old_slots[i]));
+          value_traits::destroy(values, old_slots + i);
+          m_ctrl[index] = h2(hash);
+        }
+        m_growth_left = max_load(capacity) - m_size;
+
+        if (old_capacity)
+        {
+          ctrl_traits::deallocate(ctrls, old_ctrl, old_capacity);
+          value_traits::deallocate(values, old_slots, old_capacity);
+        }
+      }
+
+      void destroy_values()
+      {
+        if constexpr (!std::is_trivially_destructible_v<value_type>)
+        {
+          value_alloc values(m_alloc);
+          for (size_t i = 0; i < m_capacity; ++i)
+            if (m_ctrl[i] >= 0)
+              value_traits::destroy(values, m_slots + i);
+        }
+      }
+
+      void release()
+      {
+        if (!m_capacity)
+          return;
+
+        destroy_values();
+
+        value_alloc values(m_alloc);
+        ctrl_alloc ctrls(m_alloc);
+        ctrl_traits::deallocate(ctrls, m_ctrl, m_capacity);
+        value_traits::deallocate(values, m_slots, m_capacity);
+
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growth_left = 0;
+      }
+
+    private:
+      i8         *m_ctrl = nullptr;
+      value_type *m_slots = nullptr;
+      size_t      m_capacity = 0;    // a multiple of group_size, and a power of 2
+      size_t      m_size = 0;
+      size_t      m_growth_left = 0; // empty slots that can still be used before rehashing
+
+      [[no_unique_address]] Hash  m_hash;
+      [[no_unique_address]] Equal m_equal;
+      [[no_unique_address]] Alloc m_alloc;
+    };
+  }
+
+  template<class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>, class Alloc = std::allocator<T>>
+  class flat_set : public detail::flat_table<T, T, detail::set_key, Hash, Equal, Alloc>
+  {
+    using base = detail::flat_table<T, T, detail::set_key, Hash, Equal, Alloc>;
+
+  public:
+    // the values are the keys: they can't be changed in place
+    using iterator = typename base::const_iterator;
+    using const_iterator = typename base::const_iterator;
+
+  public:
+    using base::base;
+
+    flat_set(std::initializer_list<T> list) { base::insert(list); }
+
+    const_iterator begin() const { return base::begin(); }
+    const_iterator end() const { return base::end(); }
+
+    const_iterator find(const T &key) const { return base::find(key); }
+  };
+
+  template<class K, class V, class Hash = std::hash<K>, class Equal = std::equal_to<K>, class Alloc = std::allocator<std::pair<const K, V>>>
+  class flat_map : public detail::flat_table<K, std::pair<const K, V>, detail::map_key, Hash, Equal, Alloc>
+  {
+    using base = detail::flat_table<K, std::pair<const K, V>, detail::map_key, Hash, Equal, Alloc>;
+
+  public:
+    using mapped_type = V;
+    using typename base::iterator;
+
+  public:
+    using base::base;
+
+    flat_map(std::initializer_list<std::pair<const K, V>> list) { base::insert(list); }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const K &key, Args &&...args)
+    {
+      return base::emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    V &operator[](const K &key) { return try_emplace(key).first->second; }
+
+    V &at(const K &key)
+    {
+      const iterator it = base::find(key);
+      if (it == base::end())
+        throw std::string("flat_map::at: no such key");
+      return it->second;
+    }
+
+    const V &at(const K &key) const
+    {
+      const auto it = base::find(key);
+      if (it == base::end())
+        throw std::string("flat_map::at: no such key");
+      return it->second;
+    }
+  };
+
+  namespace pmr
+  {
+    template<class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>>
+    using flat_set = aoc::flat_set<T, Hash, Equal, allocator<T>>;
+
+    template<class K, class V, class Hash = std::hash<K>, class Equal = std::equal_to<K>>
+    using flat_map = aoc::flat_map<K, V, Hash, Equal, allocator<std::pair<const K, V>>>;
+  }
+}
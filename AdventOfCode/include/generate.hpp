@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+// Valid inputs of any size for the implemented days, used by aoc-gen and the runner's scaling sweep.
+// The same seed gives the same input with every compiler and standard library
+namespace aoc::generate
+{
+  constexpr uint64_t default_seed = 2024;
+
+  struct generator
+  {
+    const char *name;         // of the problem: "Day 01"
+    const char *unit;         // what the size counts: "location pairs", "grid side"...
+    size_t      default_size; // large enough to stress the solver
+    size_t      puzzle_size;  // about the size of a puzzle input
+    bool        side;         // the size is the side of a square grid, the input grows with its square
+
+    void (*write)(std::ostream &out, size_t size, uint64_t seed);
+  };
+
+  // One generator per implemented day, sorted by name
+  const std::vector<generator> &generators();
+
+  // Accepts "Day 01", "01" or "1", nullptr if there is no such generator
+  const generator *find(std::string_view name);
+
+  // Writes an input of `size` units
+  void write(const generator &gen, std::ostream &out, size_t size, uint64_t seed);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstring>
+#include <iterator>
+#include <filesystem>
+#include <string_view>
+
+namespace aoc
+{
+  // Iterates over the lines of a buffer, without their "\n" or "\r\n" terminator
+  class line_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::string_view;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const std::string_view *;
+    using reference         = const std::string_view &;
+
+  public:
+    line_iterator() = default;
+    line_iterator(const char *begin, const char *end) : m_next(begin), m_end(end) { advance(); }
+
+    reference operator*() const { return m_line; }
+    pointer operator->() const { return &m_line; }
+
+    line_iterator &operator++() { advance(); return *this; }
+    line_iterator operator++(int) { line_iterator tmp = *this; advance(); return tmp; }
+
+    bool operator==(const line_iterator &other) const { return m_line.data() == other.m_line.data(); }
+    bool operator!=(const line_iterator &other) const { return m_line.data() != other.m_line.data(); }
+
+  private:
+    void advance()
+    {
+      // past the last line, compare equal to a default constructed iterator
+      if (m_next == m_end)
+      {
+        m_line = {};
+        return;
+      }
+
+      const char *eol = static_cast<const char *>(std::memchr(m_next, '\n', m_end - m_next));
+      const char *line_end = eol ? eol : m_end;
+
+      m_line = std::string_view(m_next, line_end - m_next);
+      if (!m_line.empty() && m_line.back() == '\r')
+        m_line.remove_suffix(1);
+
+      m_next = eol ? eol + 1 : m_end;
+    }
+
+  private:
+    std::string_view m_line;
+    const char      *m_next = nullptr;
+    const char      *m_end  = nullptr;
+  };
+
+  struct line_range
+  {
+    const char *first = nullptr;
+    const char *last  = nullptr;
+
+    line_iterator begin() const { return line_iterator(first, last); }
+    line_iterator end() const { return line_iterator(); }
+  };
+
+  // Read-only, memory mapped, input file.
+  // The bytes are never copied: views handed out live as long as the input
+  class input
+  {
+  public:
+    input() = default;
+    explicit input(const std::filesystem::path &path);
+    ~input();
+
+    input(input &&other) noexcept;
+    input &operator=(input &&other) noexcept;
+
+    input(const input &) = delete;
+    input &operator=(const input &) = delete;
+
+    const char *data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    std::string_view view() const { return std::string_view(m_data, m_size); }
+
+    line_range lines() const { return { m_data, m_data + m_size }; }
+
+    // The input seen as a grid of characters.
+    // Cell (x, y) is at `data()[x + y * stride()]`, stride includes the line terminator
+    size_t width() const { return m_width; }
+    size_t height() const { return m_height; }
+    size_t stride() const { return m_stride; }
+
+  private:
+    void measure();
+    void release();
+
+  private:
+    const char *m_data = nullptr;
+    size_t      m_size = 0;
+
+    size_t m_width  = 0;
+    size_t m_height = 0;
+    size_t m_stride = 0;
+  };
+}
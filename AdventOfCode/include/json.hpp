@@ -0,0 +1,25 @@
+#pragma once
+
+#include <iomanip>
+#include <ostream>
+#include <string_view>
+
+// What the json results and the trace file share
+namespace aoc::json
+{
+  // `str` as a quoted JSON string: quotes, backslashes and control characters escaped
+  inline void write_string(std::ostream &out, std::string_view str)
+  {
+    out << '"';
+    for (char c : str)
+    {
+      if (c == '"' || c == '\\')
+        out << '\\' << c;
+      else if (static_cast<unsigned char>(c) < 0x20)
+        out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec << std::setfill(' ');
+      else
+        out << c;
+    }
+    out << '"';
+  }
+}
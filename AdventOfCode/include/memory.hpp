@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Heap usage of the solvers.
+//
+// The library replaces the global operator new and delete. While a tracker is current on a thread,
+// every allocation and deallocation made by that thread is counted by the tracker.
+// The parallel algorithms of aoc::exec make the caller's tracker current on the workers running its chunks.
+// With NO_MEMORY_HOOK defined, the operators are left alone and nothing is counted.
+namespace aoc::memory
+{
+  struct usage
+  {
+    size_t allocations = 0;
+    size_t bytes       = 0; // total size of the allocations
+    size_t peak        = 0; // most bytes allocated at once, on top of what was allocated at the start
+  };
+
+  class tracker
+  {
+  public:
+    // Starting point of a measure
+    struct mark
+    {
+      size_t  allocations = 0;
+      size_t  bytes       = 0;
+      int64_t live        = 0;
+      int64_t peak        = 0; // peak of the enclosing measure
+    };
+
+    void on_allocate(size_t size) noexcept;
+    void on_deallocate(size_t size) noexcept { m_live.fetch_sub(int64_t(size), std::memory_order_relaxed); }
+
+    // Starts a measure, measures can be nested
+    mark begin() noexcept;
+
+    // Usage since `start`
+    usage end(const mark &start) noexcept;
+
+  private:
+    std::atomic<size_t>  m_allocations = 0;
+    std::atomic<size_t>  m_bytes       = 0;
+    std::atomic<int64_t> m_live        = 0; // can go below 0 when memory allocated before is freed
+    std::atomic<int64_t> m_peak        = 0;
+  };
+
+  // The tracker of this thread, if any
+  tracker *current() noexcept;
+
+  // Makes `t` the tracker of this thread for the lifetime of the scope (nullptr: no tracking)
+  class scope
+  {
+  public:
+    explicit scope(tracker *t) noexcept;
+    ~scope();
+
+    scope(const scope &) = delete;
+    scope &operator=(const scope &) = delete;
+
+  private:
+    tracker *m_previous;
+  };
+
+  // False when built with NO_MEMORY_HOOK
+  bool counts_allocations();
+
+  // Peak resident set size of the process in bytes, 0 if unknown
+  size_t peak_rss();
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <bit>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <concepts>
+#include <string_view>
+#include <type_traits>
+
+// The digit classification uses the widest vector extension the compiler targets,
+// the byte per byte loop only handles the tail of the buffer
+#if defined(__AVX2__)
+# include <immintrin.h>
+# define AOC_PARSE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define AOC_PARSE_SSE2
+#endif
+
+namespace aoc::parse
+{
+  namespace detail
+  {
+    constexpr bool is_digit(char c) { return unsigned(c - '0') < 10; }
+
+    constexpr uint64_t pow10[] = {
+      1ull, 10ull, 100ull, 1'000ull, 10'000ull, 100'000ull, 1'000'000ull, 10'000'000ull, 100'000'000ull
+    };
+
+#if defined(AOC_PARSE_AVX2)
+    constexpr std::ptrdiff_t block_size = 32;
+    constexpr uint32_t       block_bits = 0xFFFFFFFF;
+
+    // bit i is set when p[i] is a digit
+    inline uint32_t digit_mask(const char *p)
+    {
+      const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+      const __m256i above = _mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1));
+      const __m256i below = _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars);
+      return uint32_t(_mm256_movemask_epi8(_mm256_and_si256(above, below)));
+    }
+
+    // bit i is set when p[i] == c
+    inline uint32_t byte_mask(const char *p, char c)
+    {
+      const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+      return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(c))));
+    }
+#elif defined(AOC_PARSE_SSE2)
+    constexpr std::ptrdiff_t block_size = 16;
+    constexpr uint32_t       block_bits = 0x0000FFFF;
+
+    // bit i is set when p[i] is a digit
+    inline uint32_t digit_mask(const char *p)
+    {
+      const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      const __m128i above = _mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1));
+      const __m128i below = _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1));
+      return uint32_t(_mm_movemask_epi8(_mm_and_si128(above, below)));
+    }
+
+    // bit i is set when p[i] == c
+    inline uint32_t byte_mask(const char *p, char c)
+    {
+      const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(c))));
+    }
+#endif
+
+    // Returns the first digit in [p, end), or end
+    inline const char *find_digit(const char *p, const char *end)
+    {
+#if defined(AOC_PARSE_AVX2) || defined(AOC_PARSE_SSE2)
+      for (; end - p >= block_size; p += block_size)
+      {
+        if (const uint32_t mask = digit_mask(p))
+          return p + std::countr_zero(mask);
+      }
+#endif
+      while (p < end && !is_digit(*p))
+        ++p;
+      return p;
+    }
+
+    // Returns the first non digit in [p, end), or end
+    inline const char *skip_digits(const char *p, const char *end)
+    {
+#if defined(AOC_PARSE_AVX2) || defined(AOC_PARSE_SSE2)
+      for (; end - p >= block_size; p += block_size)
+      {
+        if (const uint32_t mask = ~digit_mask(p) & block_bits)
+          return p + std::countr_zero(mask);
+      }
+#endif
+      while (p < end && is_digit(*p))
+        ++p;
+      return p;
+    }
+
+    // Converts the 1 to 8 digits at `p` with 3 multiply-adds on a 64 bit word.
+    // 8 bytes must be readable from `p`, the ones after the number are shifted out
+    inline uint64_t convert_8(const char *p, std::ptrdiff_t len)
+    {
+      uint64_t val;
+      std::memcpy(&val, p, sizeof(val));
+
+      // little endian: the first digit is the lowest byte, missing digits become leading zeros
+      val <<= (8 - len) * 8;
+
+      val = ((val & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+      val = ((val & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+      return ((val & 0x0000FFFF0000FFFF) * 42949672960001) >> 32;
+    }
+
+    // Converts the digits in [p, last)
+    inline uint64_t convert(const char *p, const char *last, const char *end)
+    {
+      uint64_t result = 0;
+
+      while (p < last)
+      {
+        const std::ptrdiff_t len = std::min<std::ptrdiff_t>(last - p, 8);
+
+        if (end - p >= 8)
+          result = result * pow10[len] + convert_8(p, len);
+        else
+        {
+          for (const char *it = p; it < p + len; ++it)
+            result = result * 10 + (*it - '0');
+        }
+        p += len;
+      }
+      return result;
+    }
+
+    // The digits [first, last) as a T, `begin` bounds the lookup of a '-' sign
+    template<std::integral T>
+    inline T to_integer(const char *begin, const char *first, const char *last, const char *end)
+    {
+      const uint64_t result = convert(first, last, end);
+
+      if constexpr (std::is_signed_v<T>)
+        return (first > begin && first[-1] == '-') ? T(-int64_t(result)) : T(result);
+      else
+        return T(result);
+    }
+
+    // Reads the first integer in [p, end) into `value` and moves `p` past it.
+    // Returns the position of its first digit, or `end` if there is none
+    template<std::integral T>
+    inline const char *read(const char *&p, const char *end, T &value)
+    {
+      const char *begin = p;
+      const char *first = find_digit(p, end);
+
+      if (first == end)
+      {
+        p = end;
+        return end;
+      }
+
+      p = skip_digits(first, end);
+      value = to_integer<T>(begin, first, p, end);
+      return first;
+    }
+
+    // Calls `fn(first, last)` for every run of digits in [p, end).
+    // Each block is classified once, the numbers are then found from the bit masks
+    template<class Fn>
+    inline void for_each_number(const char *p, const char *end, Fn &&fn)
+    {
+      const char *pending = nullptr; // start of a number crossing a block boundary
+
+#if defined(AOC_PARSE_AVX2) || defined(AOC_PARSE_SSE2)
+      for (; end - p >= block_size; p += block_size)
+      {
+        const uint32_t digits = digit_mask(p);
+        const uint32_t shifted = (digits << 1) | (pending != nullptr);
+
+        uint32_t starts = digits & ~shifted;
+        uint32_t stops = ~digits & shifted & block_bits;
+
+        if (pending)
+        {
+          if (!stops)
+            continue;
+
+          fn(pending, p + std::countr_zero(stops));
+          stops &= stops - 1;
+          pending = nullptr;
+        }
+
+        // starts and stops alternate, only the last start may be left open
+        for (; starts; starts &= starts - 1)
+        {
+          const char *first = p + std::countr_zero(starts);
+
+          if (!stops)
+          {
+            pending = first;
+            break;
+          }
+
+          fn(first, p + std::countr_zero(stops));
+          stops &= stops - 1;
+        }
+      }
+#endif
+
+      if (pending)
+      {
+        p = skip_digits(p, end);
+        fn(pending, p);
+      }
+
+      while ((p = find_digit(p, end)) != end)
+      {
+        const char *first = p;
+        p = skip_digits(p, end);
+        fn(first, p);
+      }
+    }
+  }
+
+  // Reads the next integer of `str`, skipping anything before it, and removes it from `str`.
+  // For signed types, a '-' right before the digits makes the number negative
+  template<std::integral T>
+  inline bool next(std::string_view &str, T &value)
+  {
+    const char *p = str.data();
+    const char *end = str.data() + str.size();
+    const bool found = (detail::read(p, end, value) != end);
+
+    str = std::string_view(p, end - p);
+    return found;
+  }
+
+  // Appends every integer of `str` to `out`, returns how many were read
+  template<std::integral T, class Alloc>
+  inline size_t integers(std::string_view str, std::vector<T, Alloc> &out)
+  {
+    const size_t count = out.size();
+
+    const char *begin = str.data();
+    const char *end = str.data() + str.size();
+
+    detail::for_each_number(begin, end, [&](const char *first, const char *last)
+    {
+      out.push_back(detail::to_integer<T>(begin, first, last, end));
+    });
+
+    return out.size() - count;
+  }
+
+  // Reads one list of integers per line.
+  // The values of all the lists are appended to `values`, and the end of each list (an index in `values`) to `ends`.
+  // Lines without any number are skipped, returns how many lists were read
+  template<std::integral T, class Alloc, class EndsAlloc>
+  inline size_t lists(std::string_view str, std::vector<T, Alloc> &values, std::vector<size_t, EndsAlloc> &ends)
+  {
+    const size_t count = ends.size();
+    size_t list_start = values.size();
+
+    const char *p = str.data();
+    const char *end = str.data() + str.size();
+
+    T value{};
+    while (true)
+    {
+      const char *prev = p;
+      const char *first = detail::read(p, end, value);
+
+      // a line ended between the previous number and this one
+      if (values.size() > list_start && std::memchr(prev, '\n', first - prev))
+      {
+        ends.push_back(values.size());
+        list_start = values.size();
+      }
+
+      if (first == end)
+        break;
+      values.push_back(value);
+    }
+
+    if (values.size() > list_start)
+      ends.push_back(values.size());
+
+    return ends.size() - count;
+  }
+}
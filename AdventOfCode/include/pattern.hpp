@@ -0,0 +1,254 @@
+#pragma once
+
+#include "parse.hpp"
+
+#include <bit>
+#include <array>
+#include <tuple>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+
+// Compile-time patterns for the "literal + number" grammars of the inputs, replacing std::regex.
+//
+//   using mul = seq<lit<"mul(">, num<1, 3>, lit<",">, num<1, 3>, lit<")">>;
+//
+// A pattern is a type, matching it is a chain of inlined comparisons: nothing is built at runtime.
+// Every `num` captures its value, `alt` captures the index of the alternative that matched.
+// Matching never backtracks: `num` takes as many digits as it can, up to its maximum.
+namespace aoc::pattern
+{
+  template<size_t N>
+  struct fixed_string
+  {
+    char data[N - 1];
+
+    constexpr fixed_string(const char (&str)[N]) { std::copy_n(str, N - 1, data); }
+
+    static constexpr size_t size = N - 1;
+  };
+
+  // The characters a pattern can start with
+  struct charset
+  {
+    uint64_t bits[4] = {};
+
+    constexpr void insert(unsigned char c) { bits[c / 64] |= uint64_t(1) << (c % 64); }
+    constexpr bool contains(unsigned char c) const { return bits[c / 64] >> (c % 64) & 1; }
+
+    template<size_t N>
+    constexpr std::array<char, N> members() const
+    {
+      std::array<char, N> result = {};
+      size_t i = 0;
+      for (int c = 0; c < 256 && i < N; ++c)
+      {
+        if (contains((unsigned char)c))
+          result[i++] = char(c);
+      }
+      return result;
+    }
+
+    constexpr size_t count() const { return std::popcount(bits[0]) + std::popcount(bits[1]) + std::popcount(bits[2]) + std::popcount(bits[3]); }
+
+    constexpr charset operator|(const charset &other) const
+    {
+      charset result;
+      for (int i = 0; i < 4; ++i)
+        result.bits[i] = bits[i] | other.bits[i];
+      return result;
+    }
+  };
+
+  // Matches the exact string `Str`
+  template<fixed_string Str>
+  struct lit
+  {
+    static_assert(Str.size > 0, "empty literal");
+
+    static constexpr size_t captures = 0;
+
+    static constexpr charset first()
+    {
+      charset result;
+      result.insert(Str.data[0]);
+      return result;
+    }
+
+    static bool match(const char *&p, const char *end, uint64_t *)
+    {
+      if (end - p < std::ptrdiff_t(Str.size) || std::memcmp(p, Str.data, Str.size) != 0)
+        return false;
+
+      p += Str.size;
+      return true;
+    }
+  };
+
+  // Matches an unsigned number of `Min` to `Max` digits and captures its value
+  template<size_t Min = 1, size_t Max = 19>
+  struct num
+  {
+    static_assert(Min >= 1 && Min <= Max && Max <= 19, "invalid digit count");
+
+    static constexpr size_t captures = 1;
+
+    static constexpr charset first()
+    {
+      charset result;
+      for (char c = '0'; c <= '9'; ++c)
+        result.insert(c);
+      return result;
+    }
+
+    static bool match(const char *&p, const char *end, uint64_t *out)
+    {
+      const char *last = p;
+      while (last < end && size_t(last - p) < Max && parse::detail::is_digit(*last))
+        ++last;
+
+      if (size_t(last - p) < Min)
+        return false;
+
+      *out = parse::detail::convert(p, last, end);
+      p = last;
+      return true;
+    }
+  };
+
+  // Matches each pattern, one after the other
+  template<class... P>
+  struct seq
+  {
+    static_assert(sizeof...(P) > 0, "empty sequence");
+
+    static constexpr size_t captures = (P::captures + ...);
+
+    static constexpr charset first()
+    {
+      using head = std::tuple_element_t<0, std::tuple<P...>>;
+      return head::first();
+    }
+
+    static bool match(const char *&p, const char *end, uint64_t *out)
+    {
+      const char *it = p;
+      if (!(P::match(it, end, std::exchange(out, out + P::captures)) && ...))
+        return false;
+
+      p = it;
+      return true;
+    }
+  };
+
+  // Matches the first pattern that does, the first capture is its index
+  template<class... P>
+  struct alt
+  {
+    static_assert(sizeof...(P) > 0, "empty alternative");
+
+    static constexpr size_t captures = 1 + std::max({ P::captures... });
+
+    static constexpr charset first() { return (P::first() | ...); }
+
+    static bool match(const char *&p, const char *end, uint64_t *out)
+    {
+      uint64_t index = 0;
+      const bool found = ((P::match(p, end, out + 1) || (++index, false)) || ...);
+
+      out[0] = index;
+      return found;
+    }
+  };
+
+  template<class P>
+  using captures = std::array<uint64_t, P::captures>;
+
+  namespace detail
+  {
+    // Returns the first position in [p, end) a match of `P` can start at, or end
+    template<class P>
+    inline const char *find_candidate(const char *p, const char *end)
+    {
+      static constexpr charset first = P::first();
+
+      if constexpr (first.count() == 1)
+      {
+        const void *found = std::memchr(p, first.members<1>()[0], end - p);
+        return found ? static_cast<const char *>(found) : end;
+      }
+#if defined(AOC_PARSE_AVX2) || defined(AOC_PARSE_SSE2)
+      else if constexpr (first.count() <= 4)
+      {
+        // one comparison per possible first character, a whole block at a time
+        static constexpr std::array<char, first.count()> chars = first.members<first.count()>();
+
+        for (; end - p >= parse::detail::block_size; p += parse::detail::block_size)
+        {
+          const uint32_t mask = [p]<size_t... I>(std::index_sequence<I...>)
+          {
+            return (parse::detail::byte_mask(p, chars[I]) | ...);
+          }(std::make_index_sequence<chars.size()>());
+
+          if (mask)
+            return p + std::countr_zero(mask);
+        }
+      }
+#endif
+
+      while (p < end && !first.contains(*p))
+        ++p;
+      return p;
+    }
+  }
+
+  // Matches `P` against the whole of `str`
+  template<class P>
+  inline bool match(std::string_view str, captures<P> &caps)
+  {
+    const char *p = str.data();
+    const char *end = str.data() + str.size();
+
+    return P::match(p, end, caps.data()) && p == end;
+  }
+
+  // Matches `P` at the start of `str`, and removes the matched characters from `str`
+  template<class P>
+  inline bool consume(std::string_view &str, captures<P> &caps)
+  {
+    const char *p = str.data();
+    const char *end = str.data() + str.size();
+
+    if (!P::match(p, end, caps.data()))
+      return false;
+
+    str = std::string_view(p, end - p);
+    return true;
+  }
+
+  // Calls `fn(caps)` for every occurrence of `P` in `str`, from left to right.
+  // Returns the number of occurrences
+  template<class P, class Fn>
+  inline size_t search(std::string_view str, Fn &&fn)
+  {
+    const char *p = str.data();
+    const char *end = str.data() + str.size();
+
+    size_t count = 0;
+    captures<P> caps;
+    while ((p = detail::find_candidate<P>(p, end)) != end)
+    {
+      if (P::match(p, end, caps.data()))
+      {
+        fn(std::as_const(caps));
+        ++count;
+      }
+      else
+        ++p;
+    }
+    return count;
+  }
+}
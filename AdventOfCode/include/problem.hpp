@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+namespace aoc
+{
+  class problem;
+
+  // What a solver gets to know about the run it is part of
+  struct context
+  {
+    const aoc::problem   &problem;
+    std::filesystem::path input;
+  };
+
+  using solver = void (*)(const context &);
+
+  // A solver that registers itself on construction.
+  // Each day declares one static instance, the runner then finds it through `problems()`
+  class problem
+  {
+  public:
+    problem(const char *name, solver solve);
+
+    problem(const problem &) = delete;
+    problem &operator=(const problem &) = delete;
+
+  public:
+    const std::string name;
+    const solver      solve;
+  };
+
+  // Every problem linked in the executable, sorted by name
+  const std::vector<const problem *> &problems();
+}
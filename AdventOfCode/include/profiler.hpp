@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Timer.hpp"
+#include "memory.hpp"
+#include "counters.hpp"
+#include "trace.hpp"
+
+#include <string>
+#include <vector>
+
+namespace aoc
+{
+  // Time spent in a named phase of a solver (parsing, part 1, ...)
+  struct phase
+  {
+    std::string name;
+    size_t      parent = npos; // index of the enclosing phase
+    size_t      depth  = 0;
+    size_t      calls  = 0;
+    double      micros = 0;
+
+    memory::usage memory;   // heap usage of the phase, when the run is tracked
+    perf::sample  counters; // hardware counters of the phase, when enabled
+
+    static constexpr size_t npos = size_t(-1);
+  };
+
+  // Tree of the phases entered while solving a problem.
+  // Entering the same phase twice under the same parent accumulates its time
+  class profile
+  {
+  public:
+    size_t begin(const char *name);
+    void end(size_t index, double micros);
+
+    void clear();
+
+    const std::vector<phase> &phases() const { return m_phases; }
+
+  private:
+    struct frame
+    {
+      size_t                   index;
+      const char              *name;
+      memory::tracker::mark    start    = {};
+      perf::sample             counters = {};
+      trace::clock::time_point begin    = {};
+    };
+
+    std::vector<phase> m_phases;
+    std::vector<frame> m_stack;
+  };
+
+  // one profile per thread, the runner collects it after each run
+  extern thread_local profile profiler;
+
+  // Times the enclosing scope as a phase of the current problem
+  //   aoc::scoped_timer timer("parse");
+  class scoped_timer
+  {
+  public:
+    explicit scoped_timer(const char *name) : m_index(profiler.begin(name)) {}
+    ~scoped_timer() { stop(); }
+
+    scoped_timer(const scoped_timer &) = delete;
+    scoped_timer &operator=(const scoped_timer &) = delete;
+
+    // ends the phase before the end of the scope
+    void stop()
+    {
+      if (m_index == phase::npos)
+        return;
+
+      profiler.end(m_index, m_timer.GetTime<double, std::micro>());
+      m_index = phase::npos;
+    }
+
+  private:
+    size_t m_index;
+    timer  m_timer; // started last, so the bookkeeping is not timed
+  };
+}
@@ -3,9 +3,15 @@
 #include "vec.hpp"
 
 #include <string>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <cassert>
+#include <new>
+#include <bit>
 #include <iostream>
+#include <algorithm>
 
 namespace aoc
 {
@@ -15,58 +21,490 @@ namespace aoc
     constexpr T operator()(char c) { return T(c); };
   };
 
-  template<class T = i8, class Loader=loader<T>>
+  namespace detail
+  {
+    // Storage of the maps, on a cache line
+    template<class T>
+    struct line_allocator
+    {
+      using value_type = T;
+      static constexpr size_t alignment = 64;
+
+      line_allocator() = default;
+      template<class U>
+      line_allocator(const line_allocator<U> &) noexcept {}
+
+      T *allocate(size_t n) { return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignment))); }
+      void deallocate(T *p, size_t) noexcept { ::operator delete(p, std::align_val_t(alignment)); }
+
+      template<class U>
+      bool operator==(const line_allocator<U> &) const { return true; }
+    };
+  }
+
+  // Where the cells of a map are stored. A layout places the cell (x, y), x and y from -padding to size + padding - 1,
+  // in the storage of the map:
+  //   Layout(vec2s size, size_t padding, size_t cell_size)
+  //   size_t cells() const                          length of the storage
+  //   size_t index(ptrdiff_t x, ptrdiff_t y) const  position of a cell in the storage
+  //   bool next(vec2s &pos, vec2s size) const       the cell of the map stored after `pos`, false after the last one
+  namespace layout
+  {
+    // Row after row, as the lines of a text. Padded rows start on 64 bytes when 64 is a multiple of the cell size
+    class row_major
+    {
+    public:
+      static constexpr size_t alignment = detail::line_allocator<char>::alignment;
+
+    public:
+      row_major() = default;
+      row_major(vec2s size, size_t padding, size_t cell_size)
+      {
+        if (!padding)
+        {
+          m_stride = size.w;
+          m_cells = size.w * size.h;
+          return;
+        }
+
+        // the cells of a line, when whole cells fit in it
+        const size_t line = (alignment % cell_size == 0) ? alignment / cell_size : 1;
+        const size_t lead = (padding + line - 1) / line * line;
+
+        m_stride = (lead + size.w + padding + line - 1) / line * line;
+        m_origin = padding * m_stride + lead;
+        m_cells = m_stride * (size.h + 2 * padding);
+      }
+
+      // Lines of `stride` cells, the last one of `width` cells
+      static row_major lines(vec2s size, size_t stride)
+      {
+        row_major layout;
+        layout.m_stride = stride;
+        layout.m_cells = size.h ? (size.h - 1) * stride + size.w : 0;
+        return layout;
+      }
+
+      size_t cells() const { return m_cells; }
+      size_t stride() const { return m_stride; }
+      size_t origin() const { return m_origin; }
+
+      size_t index(ptrdiff_t x, ptrdiff_t y) const { return m_origin + size_t(x + y * ptrdiff_t(m_stride)); }
+
+      bool next(vec2s &pos, vec2s size) const
+      {
+        if (++pos.x < size.w)
+          return true;
+
+        pos.x = 0;
+        return ++pos.y < size.h;
+      }
+
+    private:
+      size_t m_stride = 0;
+      size_t m_origin = 0; // index of the cell (0, 0)
+      size_t m_cells = 0;
+    };
+
+    // Square tiles of Side x Side cells stored row after row, themselves row after row.
+    // The vertical neighbours of a cell are in the same tile but on its edges: 8 x 8 tiles of bytes are a cache line
+    template<size_t Side = 8>
+    class tiled
+    {
+      static_assert(std::has_single_bit(Side), "the side of the tiles must be a power of 2");
+
+    public:
+      tiled() = default;
+      tiled(vec2s size, size_t padding, size_t)
+        : m_padding(padding), m_tiles((size.w + 2 * padding + Side - 1) / Side)
+      {
+        m_cells = m_tiles * ((size.h + 2 * padding + Side - 1) / Side) * Side * Side;
+      }
+
+      size_t cells() const { return m_cells; }
+
+      size_t index(ptrdiff_t x, ptrdiff_t y) const
+      {
+        const size_t px = size_t(x + ptrdiff_t(m_padding));
+        const size_t py = size_t(y + ptrdiff_t(m_padding));
+        return ((py / Side) * m_tiles + px / Side) * (Side * Side) + (py % Side) * Side + px % Side;
+      }
+
+      bool next(vec2s &pos, vec2s size) const
+      {
+        // in padded coordinates, the corner of the tile of `pos`
+        const size_t px = pos.x + m_padding;
+        const size_t py = pos.y + m_padding;
+        const size_t tile_x = px / Side * Side;
+        const size_t tile_y = py / Side * Side;
+
+        if ((px + 1) % Side && pos.x + 1 < size.w)
+        {
+          ++pos.x;
+          return true;
+        }
+        if ((py + 1) % Side && pos.y + 1 < size.h)
+        {
+          pos.x = std::max(tile_x, m_padding) - m_padding;
+          ++pos.y;
+          return true;
+        }
+
+        // the first row of the next tile, or of the next row of tiles
+        pos.y = std::max(tile_y, m_padding) - m_padding;
+        if (tile_x + Side - m_padding < size.w)
+        {
+          pos.x = tile_x + Side - m_padding;
+          return true;
+        }
+
+        pos.x = 0;
+        pos.y = tile_y + Side - m_padding;
+        return pos.y < size.h;
+      }
+
+    private:
+      size_t m_padding = 0;
+      size_t m_tiles = 0; // per row of tiles
+      size_t m_cells = 0;
+    };
+
+    // Z-order: the bits of x and y interleaved, every aligned square of 2^n x 2^n cells is stored in one piece.
+    // The storage is sized to powers of 2: a 5000 x 5000 map takes 8192 x 8192 cells
+    class morton
+    {
+    public:
+      morton() = default;
+      morton(vec2s size, size_t padding, size_t) : m_padding(padding)
+      {
+        const size_t width = size.w + 2 * padding;
+        const size_t height = size.h + 2 * padding;
+
+        // the smallest powers of 2 holding the padded sides
+        m_bits_x = width ? size_t(std::bit_width(width - 1)) : 0;
+        m_bits_y = height ? size_t(std::bit_width(height - 1)) : 0;
+        m_common = std::min(m_bits_x, m_bits_y);
+        m_cells = (width && height) ? size_t(1) << (m_bits_x + m_bits_y) : 0;
+      }
+
+      size_t cells() const { return m_cells; }
+
+      size_t index(ptrdiff_t x, ptrdiff_t y) const
+      {
+        return code(size_t(x + ptrdiff_t(m_padding)), size_t(y + ptrdiff_t(m_padding)));
+      }
+
+      bool next(vec2s &pos, vec2s size) const
+      {
+        // the codes of the padding and past the map are skipped
+        for (size_t c = code(pos.x + m_padding, pos.y + m_padding) + 1; c < m_cells; ++c)
+        {
+          const size_t px = decode(c, 0);
+          const size_t py = decode(c, 1);
+          if (px >= m_padding && py >= m_padding && px - m_padding < size.w && py - m_padding < size.h)
+          {
+            pos = { px - m_padding, py - m_padding };
+            return true;
+          }
+        }
+        return false;
+      }
+
+    private:
+      // the bits of `v` on the even bits of the result
+      static u64 spread(u64 v)
+      {
+        v &= 0xFFFFFFFF;
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFF;
+        v = (v | (v << 8))  & 0x00FF00FF00FF00FF;
+        v = (v | (v << 4))  & 0x0F0F0F0F0F0F0F0F;
+        v = (v | (v << 2))  & 0x3333333333333333;
+        v = (v | (v << 1))  & 0x5555555555555555;
+        return v;
+      }
+
+      static u64 compact(u64 v)
+      {
+        v &= 0x5555555555555555;
+        v = (v | (v >> 1))  & 0x3333333333333333;
+        v = (v | (v >> 2))  & 0x0F0F0F0F0F0F0F0F;
+        v = (v | (v >> 4))  & 0x00FF00FF00FF00FF;
+        v = (v | (v >> 8))  & 0x0000FFFF0000FFFF;
+        v = (v | (v >> 16)) & 0x00000000FFFFFFFF;
+        return v;
+      }
+
+      // past the bits common to both sides, the longest one goes on top
+      size_t code(size_t px, size_t py) const
+      {
+        const size_t mask = (size_t(1) << m_common) - 1;
+        const size_t high = (m_bits_x > m_bits_y) ? px >> m_common : py >> m_common;
+        return size_t(spread(px & mask) | (spread(py & mask) << 1)) | (high << (2 * m_common));
+      }
+
+      // x (axis 0) or y (axis 1) of a code
+      size_t decode(size_t c, int axis) const
+      {
+        const size_t high = c >> (2 * m_common);
+        const size_t low = size_t(compact(c >> axis)) & ((size_t(1) << m_common) - 1);
+        const bool longest = (axis == 0) == (m_bits_x > m_bits_y);
+        return low | (longest ? high << m_common : 0);
+      }
+
+    private:
+      size_t m_padding = 0;
+      size_t m_bits_x = 0; // the storage is 2^bits_x x 2^bits_y cells
+      size_t m_bits_y = 0;
+      size_t m_common = 0;
+      size_t m_cells = 0;
+    };
+  }
+
+  // A grid of cells, stored row by row by default.
+  //
+  // A padded map is surrounded by `padding` cells of a sentinel value on every side: positions from -padding to
+  // size + padding - 1 can be read, so a loop stopping on the sentinel needs no bounds check for its neighbours.
+  // Its rows are then `stride()` cells apart, and cell 0 of each row starts on 64 bytes when 64 is a multiple of sizeof(T).
+  //
+  // A view (`rect_map::view`) reads the lines of a text in place, terminators included in its stride: it copies
+  // nothing, must not outlive the bytes, and its cells can't be written when they are read-only (a mapped input).
+  // Copying a view copies its cells.
+  //
+  // Another `Layout` (layout::tiled, layout::morton) keeps vertical neighbours closer, behind the same operator[].
+  // Iterating over a map visits its cells in the order of their storage, `pos()` telling where they are.
+  template<class T = i8, class Loader=loader<T>, class Layout = layout::row_major>
   class rect_map
   {
+  public:
+    using layout_type = Layout;
+
+    static constexpr bool row_major = std::is_same_v<Layout, layout::row_major>;
+
+    // characters are their own cells: a text can be read in place
+    static constexpr bool identity = (std::is_same_v<T, char> || std::is_same_v<T, i8>) && std::is_same_v<Loader, loader<T>>;
+
+    template<bool Const>
+    class cell_iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type        = T;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = std::conditional_t<Const, const T *, T *>;
+      using reference         = std::conditional_t<Const, const T &, T &>;
+
+    public:
+      cell_iterator() = default;
+      cell_iterator(pointer cells, const Layout *layout, vec2s size, vec2s pos) : m_cells(cells), m_layout(layout), m_size(size), m_pos(pos) {}
+
+      reference operator*() const { return m_cells[m_layout->index(ptrdiff_t(m_pos.x), ptrdiff_t(m_pos.y))]; }
+      pointer operator->() const { return &**this; }
+
+      // Position of the cell in the map
+      vec2s pos() const { return m_pos; }
+
+      cell_iterator &operator++()
+      {
+        // past the last cell: the position of end()
+        if (!m_layout->next(m_pos, m_size))
+          m_pos = { 0, m_size.h };
+        return *this;
+      }
+      cell_iterator operator++(int) { cell_iterator tmp = *this; ++*this; return tmp; }
+
+      bool operator==(const cell_iterator &other) const { return m_pos == other.m_pos; }
+
+    private:
+      pointer       m_cells = nullptr;
+      const Layout *m_layout = nullptr;
+      vec2s         m_size = { 0, 0 };
+      vec2s         m_pos = { 0, 0 };
+    };
+
+    using iterator = cell_iterator<false>;
+    using const_iterator = cell_iterator<true>;
+
   public:
     rect_map() = default;
-    rect_map(size_t width, size_t height, const T &v = T())
-      : m_size(width, height), m_data(width * height, v) {}
+    rect_map(size_t width, size_t height, const T &v = T()) requires row_major
+      : m_size(width, height), m_layout(m_size, 0, sizeof(T)), m_data(width * height, v), m_cells(m_data.data()) {}
+    rect_map(size_t width, size_t height, const T &v = T()) requires (!row_major)
+      : rect_map(width, height, v, 0, v) {}
+
+    rect_map(size_t width, size_t height, const T &v, size_t padding, const T &sentinel)
+      : m_size(width, height), m_padding(padding), m_layout(m_size, padding, sizeof(T))
+    {
+      m_data.assign(m_layout.cells(), sentinel);
+      m_cells = m_data.data();
+
+      if constexpr (row_major)
+      {
+        for (size_t y = 0; y < height; ++y)
+          std::fill_n(row(y), width, v);
+      }
+      else
+      {
+        for (size_t y = 0; y < height; ++y)
+          for (size_t x = 0; x < width; ++x)
+            m_cells[m_layout.index(ptrdiff_t(x), ptrdiff_t(y))] = v;
+      }
+    }
+
+    // The lines of `text`, see load()
+    explicit rect_map(std::string_view text) { load(text); }
+    rect_map(std::string_view text, size_t padding, const T &sentinel) : m_padding(padding) { load(text, sentinel); }
+
+    rect_map(const rect_map &other)
+      : m_size(other.m_size), m_padding(other.m_padding), m_layout(other.m_layout), m_data(other.m_data)
+    {
+      if (other.is_view())
+        m_data.assign(other.m_cells, other.m_cells + m_layout.cells());
+      m_cells = m_data.data();
+    }
+
+    rect_map(rect_map &&other) noexcept
+      : m_size(other.m_size), m_padding(other.m_padding), m_layout(other.m_layout),
+        m_data(std::move(other.m_data)), m_cells(other.m_cells)
+    {
+      other.m_cells = other.m_data.data();
+    }
+
+    rect_map &operator=(rect_map other) noexcept
+    {
+      std::swap(m_size, other.m_size);
+      std::swap(m_padding, other.m_padding);
+      std::swap(m_layout, other.m_layout);
+      std::swap(m_data, other.m_data);
+      std::swap(m_cells, other.m_cells);
+      return *this;
+    }
+
+    // Reads the lines of `text` in place, without copying them
+    static rect_map view(std::string_view text) requires (identity && row_major)
+    {
+      rect_map map;
+      const size_t line = map.measure(text);
+      map.m_layout = layout::row_major::lines(map.m_size, line);
+      map.m_cells = const_cast<T *>(reinterpret_cast<const T *>(text.data()));
+      return map;
+    }
 
     vec2s size() const { return m_size; }
     size_t width() const { return m_size.w; }
     size_t height() const { return m_size.h; }
 
-    T *data() { return m_data.data(); }
-    const T *data() const { return m_data.data(); }
+    // Cells of sentinel around the map, 0 when it is not padded
+    size_t padding() const { return m_padding; }
+    bool padded() const { return m_padding != 0; }
+
+    const Layout &layout() const { return m_layout; }
+
+    // Distance between two rows, in cells: the width of an unpadded map, the length of a line for a view
+    size_t stride() const requires row_major { return m_layout.stride(); }
+
+    // Whether the cells are the bytes of a text, not owned by the map
+    bool is_view() const { return m_cells != m_data.data(); }
+
+    // The whole storage, padding included
+    T *data() { return m_cells; }
+    const T *data() const { return m_cells; }
+
+    // Cell 0 of row `y`, the cells of the padding are before and after it
+    T *row(size_t y) requires row_major { return m_cells + m_layout.origin() + y * m_layout.stride(); }
+    const T *row(size_t y) const requires row_major { return m_cells + m_layout.origin() + y * m_layout.stride(); }
 
     template<class U>
     requires std::is_integral_v<U>
-    T &operator[](vec<2, U> pos) { return m_data[pos.x + pos.y * m_size.w]; }
+    T &operator[](vec<2, U> pos) { return m_cells[m_layout.index(ptrdiff_t(pos.x), ptrdiff_t(pos.y))]; }
     template<class U>
     requires std::is_integral_v<U>
-    const T &operator[](vec<2, U> pos) const { return m_data[pos.x + pos.y * m_size.w]; }
+    const T &operator[](vec<2, U> pos) const { return m_cells[m_layout.index(ptrdiff_t(pos.x), ptrdiff_t(pos.y))]; }
 
     template<class U>
     requires std::is_integral_v<U>
     bool contains(vec<2, U> pos) const { return pos.x >= 0 && pos.x < m_size.w && pos.y >= 0 && pos.y < m_size.h; }
 
-    void reserve(size_t size) { m_data.reserve(size); }
+    // The cells of the map in storage order, without the padding
+    iterator begin() { return iterator(m_cells, &m_layout, m_size, first()); }
+    iterator end() { return iterator(m_cells, &m_layout, m_size, { 0, m_size.h }); }
+    const_iterator begin() const { return const_iterator(m_cells, &m_layout, m_size, first()); }
+    const_iterator end() const { return const_iterator(m_cells, &m_layout, m_size, { 0, m_size.h }); }
+
+    void reserve(size_t size)
+    {
+      if (!is_view())
+      {
+        m_data.reserve(size);
+        m_cells = m_data.data();
+      }
+    }
+
+    // Replaces the cells with the lines of `text`, all as long as the first one ("\n" or "\r\n" terminated).
+    // The map is sized once, then each line goes through the loader in one pass. Keeps the padding and its sentinel.
+    void load(std::string_view text)
+    {
+      // every cell but the padding is loaded: without padding, any value fills the map
+      load(text, (padded() && !is_view()) ? m_data.front() : Loader()('\0'));
+    }
 
     friend std::istream &operator>>(std::istream &is, rect_map &map)
     {
-      std::string line;
+      const std::string text((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+      map.load(text);
+      return is;
+    }
+
+
+  private:
+    void load(std::string_view text, const T &sentinel)
+    {
+      const size_t line = measure(text);
+
+      m_layout = Layout(m_size, m_padding, sizeof(T));
+      m_data.assign(m_layout.cells(), sentinel);
+      m_cells = m_data.data();
 
-      map.m_size = { 0, 0 };
-      while (std::getline(is, line))
+      for (size_t y = 0; y < m_size.h; ++y)
       {
-        if (map.m_size.w)
-          assert(line.size() == map.m_size.w);
+        const char *first = text.data() + y * line;
+        assert(y + 1 == m_size.h || first[m_size.w] == '\n' || first[m_size.w] == '\r');
+
+        if constexpr (row_major)
+          std::transform(first, first + m_size.w, row(y), Loader());
         else
-          map.m_size.w = line.size();
+        {
+          for (size_t x = 0; x < m_size.w; ++x)
+            m_cells[m_layout.index(ptrdiff_t(x), ptrdiff_t(y))] = Loader()(first[x]);
+        }
+      }
+    }
+
+    // Sizes the map after the lines of `text`: returns the length of a line, terminator included
+    size_t measure(std::string_view text)
+    {
+      const size_t eol = text.find('\n');
 
-        for (auto &c : line)
-          map.m_data.push_back(Loader()(c));
-        //map.m_data.insert(map.data.end(), line.begin(), line.end());
+      const size_t line = (eol == std::string_view::npos) ? text.size() : eol + 1;
+      size_t width = (eol == std::string_view::npos) ? text.size() : eol;
+      if (width > 0 && text[width - 1] == '\r')
+        --width;
 
-        ++map.m_size.h;
-      }
-      return is;
+      // the last line may not be terminated
+      size_t height = line ? text.size() / line : 0;
+      if (line && text.size() % line >= std::max<size_t>(width, 1))
+        ++height;
+
+      m_size = { width, height };
+      return line;
     }
 
+    vec2s first() const { return (m_size.w && m_size.h) ? vec2s{ 0, 0 } : vec2s{ 0, m_size.h }; }
 
   private:
-    vec2s m_size = { 0, 0 };
-    std::vector<T> m_data;
+    vec2s  m_size = { 0, 0 };
+    size_t m_padding = 0;
+    Layout m_layout;
+    std::vector<T, detail::line_allocator<T>> m_data;
+    T     *m_cells = nullptr; // m_data, or the text of a view
   };
-}
\ No newline at end of file
+}
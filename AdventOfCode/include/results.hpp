@@ -0,0 +1,50 @@
+#pragma once
+
+#include "stats.hpp"
+#include "Output.hpp"
+#include "memory.hpp"
+#include "problem.hpp"
+#include "counters.hpp"
+#include "profiler.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <filesystem>
+
+namespace aoc
+{
+  // Everything the runner measured about a problem
+  struct result
+  {
+    const aoc::problem     *problem = nullptr;
+    std::string             input;        // file solved in batch mode, empty for the problem's own
+    bool                    cached = false; // answers read from the cache, nothing else was measured
+    aoc::output             output;
+    aoc::stats              stats;        // in microseconds
+    std::vector<aoc::phase> phases;       // median time of each phase
+    aoc::memory::usage      memory;       // heap usage of the last run
+    size_t                  peak_rss = 0; // 0 when the memory was not measured
+    aoc::perf::sample       counters;     // of the last run
+    std::string             error;
+  };
+
+  // Results in a form other tools can read, to keep track of them from one build to the next
+  namespace results
+  {
+    enum class format
+    {
+      json, // one object per problem and per line
+      csv   // one row per problem, followed by one row per phase
+    };
+
+    // csv for a ".csv" file, json otherwise
+    format format_of(const std::filesystem::path &path);
+
+    void write(std::ostream &out, std::vector<result> &results, format fmt);
+
+    // Median run time in microseconds of every problem of a file written by write(), but the cached ones
+    std::map<std::string, double> read_medians(const std::filesystem::path &path);
+  }
+}
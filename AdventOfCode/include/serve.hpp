@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <filesystem>
+#include <string_view>
+
+// Problems solved on request by a long running process, over a local Unix domain socket.
+//
+// A connection carries any number of requests, one after the other: the name of a problem and the bytes of
+// its input. Each one gets the answers back with the time taken by the solver.
+// Only available where Unix domain sockets are (Linux, macOS)
+namespace aoc::serve
+{
+  constexpr const char *default_socket = "aoc-serve.sock";
+
+  struct response
+  {
+    bool        solved = false;
+    double      micros = 0; // taken by the solver, in the server
+    std::string text;       // the answers, one per line, or the error
+  };
+
+  // Solves the problem `name` on the input file `input`, in the server
+  using handler = std::function<response(std::string_view name, const std::filesystem::path &input)>;
+
+  bool supported();
+
+  // Answers the requests made on the socket `path` until the process is stopped, each connection on its own thread.
+  // Up to 64 connections are served at once, the others wait for one of them to close.
+  // The input of a request is written to a file in memory owned by its connection
+  [[noreturn]] void listen(const std::filesystem::path &path, const handler &handle);
+
+  class client
+  {
+  public:
+    explicit client(const std::filesystem::path &path);
+    ~client();
+
+    client(const client &) = delete;
+    client &operator=(const client &) = delete;
+
+    response solve(std::string_view name, std::string_view input);
+
+  private:
+    int m_socket = -1;
+  };
+}
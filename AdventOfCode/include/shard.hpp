@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+// Work spread over forked worker processes, on a single machine.
+//
+// The items are claimed from a queue in shared memory, each worker sends back what it made of them
+// through its own ring buffer, also in shared memory, that the parent process drains.
+// Workers don't share an allocator or a pool: a solver can't slow down the others through them.
+// Only available where fork() is (Linux, macOS)
+namespace aoc::shard
+{
+  // Largest payload a worker can send back for an item, longer ones are cut and flagged
+  constexpr size_t payload_capacity = 4096;
+
+  // Computes the payload of item `index`, in a worker process
+  using worker_fn = std::function<std::string(size_t index)>;
+
+  // Receives the payload of item `index`, in the parent process.
+  // An empty payload means the worker died while working on the item, `truncated` that it was cut to payload_capacity
+  using collect_fn = std::function<void(size_t index, std::string_view payload, bool truncated)>;
+
+  bool supported();
+
+  // Runs `work` on every item in [0, count) in `processes` workers (0: one per core),
+  // each one pinned to its share of the cores the parent may run on, and with as many pool threads.
+  // Returns once every item was collected, or lost with its worker
+  void run(size_t count, unsigned processes, const worker_fn &work, const collect_fn &collect);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+namespace aoc
+{
+  // Summary of a set of samples (typically run times)
+  struct stats
+  {
+    size_t count  = 0;
+    double min    = 0;
+    double median = 0;
+    double p90    = 0;
+    double p99    = 0;
+    double max    = 0;
+    double mean   = 0;
+    double stddev = 0;
+
+    static stats compute(std::vector<double> samples)
+    {
+      stats result;
+
+      if (samples.empty())
+        return result;
+
+      std::sort(samples.begin(), samples.end());
+
+      const size_t n = samples.size();
+      const double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
+
+      result.count  = n;
+      result.min    = samples.front();
+      result.max    = samples.back();
+      result.mean   = sum / n;
+      result.median = percentile(samples, 0.50);
+      result.p90    = percentile(samples, 0.90);
+      result.p99    = percentile(samples, 0.99);
+
+      double variance = 0;
+      for (double sample : samples)
+        variance += (sample - result.mean) * (sample - result.mean);
+      result.stddev = std::sqrt(variance / n);
+
+      return result;
+    }
+
+    // linear interpolation between the closest ranks, `sorted` must not be empty
+    static double percentile(const std::vector<double> &sorted, double p)
+    {
+      const double rank = p * (sorted.size() - 1);
+      const size_t low = size_t(rank);
+      const size_t high = std::min(low + 1, sorted.size() - 1);
+
+      return sorted[low] + (sorted[high] - sorted[low]) * (rank - low);
+    }
+  };
+}
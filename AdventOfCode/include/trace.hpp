@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+// Timeline of the runs, phases and parallel chunks of every thread, in the Chrome trace event format.
+// The file written by trace::write() opens in chrome://tracing or https://ui.perfetto.dev
+//
+// Each thread records in its own buffer, nothing is recorded until enable() is called.
+// Event names are not copied: they must outlive the trace (string literals, problem names...)
+namespace aoc::trace
+{
+  using clock = std::chrono::steady_clock;
+
+  void enable();
+  bool enabled();
+
+  // Name of the calling thread in the trace
+  void name_thread(std::string name);
+
+  // An event from `begin` to `end` on the calling thread, `index` is shown in its arguments when not negative
+  void record(std::string_view name, const char *category, clock::time_point begin, clock::time_point end, int64_t index = -1);
+
+  // A point in time on the calling thread
+  void instant(std::string_view name, const char *category);
+
+  // Records the lifetime of the scope as an event
+  class span
+  {
+  public:
+    span(std::string_view name, const char *category, int64_t index = -1)
+      : m_name(name), m_category(category), m_index(index)
+    {
+      if (enabled())
+        m_begin = clock::now();
+    }
+
+    ~span()
+    {
+      if (m_begin != clock::time_point())
+        record(m_name, m_category, m_begin, clock::now(), m_index);
+    }
+
+    span(const span &) = delete;
+    span &operator=(const span &) = delete;
+
+  private:
+    std::string_view  m_name;
+    const char       *m_category;
+    int64_t           m_index;
+    clock::time_point m_begin;
+  };
+
+  // Writes the events of every thread, must not be called while events are being recorded
+  void write(const std::filesystem::path &path);
+}
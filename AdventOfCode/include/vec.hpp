@@ -2,6 +2,10 @@
 
 #include "types.hpp"
 
+#include <ostream>
+#include <functional>
+#include <type_traits>
+
 namespace aoc
 {
   template<size_t Comp, class T>
@@ -199,6 +203,17 @@ namespace aoc
 
   using vec2b  = vec<2, bool>;
   using vec2s  = vec<2, size_t>;
+
+  // Finalizer of murmur3: every bit of `value` flips about half the bits of the result
+  constexpr u64 hash_mix(u64 value)
+  {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCD;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53;
+    value ^= value >> 33;
+    return value;
+  }
 }
 
 template <class T>
@@ -214,14 +229,18 @@ struct std::less<aoc::vec<2, T>>
 template<class T>
 struct std::hash<aoc::vec<2, T>>
 {
+  // Coordinates of up to 32 bits are packed in a single word: neighbouring points never collide before the mix
   constexpr size_t operator()(const aoc::vec<2, T> &value) const
   {
-    constexpr std::hash<T> hasher;
-
-    size_t hash = 0;
-    hash ^= hasher(value.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    hash ^= hasher(value.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    return hash;
+    if constexpr (std::is_integral_v<T> && sizeof(T) <= 4)
+      return size_t(aoc::hash_mix((aoc::u64(aoc::u32(value.x)) << 32) | aoc::u32(value.y)));
+    else if constexpr (std::is_integral_v<T>)
+      return size_t(aoc::hash_mix(aoc::hash_mix(aoc::u64(value.x)) ^ aoc::u64(value.y)));
+    else
+    {
+      const std::hash<T> hasher;
+      return size_t(aoc::hash_mix(aoc::hash_mix(hasher(value.x)) ^ hasher(value.y)));
+    }
   }
 };
 
@@ -0,0 +1,92 @@
+#include "AdventOfCode.hpp"
+
+#include "arena.hpp"
+
+namespace aoc
+{
+  namespace
+  {
+    thread_local std::pmr::memory_resource *resource = nullptr;
+  }
+
+  arena::~arena()
+  {
+    for (block &b : m_blocks)
+      ::operator delete(b.data);
+  }
+
+  size_t arena::capacity() const
+  {
+    size_t total = 0;
+    for (const block &b : m_blocks)
+      total += b.size;
+    return total;
+  }
+
+  void arena::reset()
+  {
+    if (m_blocks.size() > 1)
+    {
+      const size_t total = capacity();
+
+      for (block &b : m_blocks)
+        ::operator delete(b.data);
+      m_blocks.clear();
+
+      add_block(total);
+    }
+
+    m_current = 0;
+    m_offset = 0;
+    m_used = 0;
+  }
+
+  void arena::add_block(size_t size)
+  {
+    m_blocks.push_back({ static_cast<std::byte *>(::operator new(size)), size });
+  }
+
+  void *arena::do_allocate(size_t bytes, size_t alignment)
+  {
+    while (m_current < m_blocks.size())
+    {
+      const block &b = m_blocks[m_current];
+
+      const uintptr_t base = reinterpret_cast<uintptr_t>(b.data);
+      const size_t offset = ((base + m_offset + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+
+      if (offset + bytes <= b.size)
+      {
+        m_offset = offset + bytes;
+        m_used += bytes;
+        return b.data + offset;
+      }
+
+      ++m_current;
+      m_offset = 0;
+    }
+
+    // each block is at least twice as large as the previous one
+    size_t size = m_blocks.empty() ? m_block_size : m_blocks.back().size * 2;
+    size = std::max(size, bytes + alignment);
+
+    add_block(size);
+    m_current = m_blocks.size() - 1;
+    return do_allocate(bytes, alignment);
+  }
+
+  std::pmr::memory_resource *current_resource()
+  {
+    return resource ? resource : std::pmr::new_delete_resource();
+  }
+
+  arena_scope::arena_scope(arena &a) : m_previous(resource)
+  {
+    resource = &a;
+  }
+
+  arena_scope::~arena_scope()
+  {
+    resource = m_previous;
+  }
+}
@@ -0,0 +1,196 @@
+#include "AdventOfCode.hpp"
+
+#include "cache.hpp"
+
+#ifdef WINDOWS
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <windows.h>
+#endif
+
+#ifdef MACOSX
+# include <mach-o/dyld.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+# include <intrin.h>
+#endif
+
+namespace aoc::cache
+{
+  namespace
+  {
+    constexpr uint64_t secret[4] = {
+      0xA0761D6478BD642F,
+      0xE7037ED1A0B428DB,
+      0x8EBC6AF09C88C6E3,
+      0x589965CC75374CC3
+    };
+
+    // Both halves of the 128-bit product, folded
+    uint64_t fold_multiply(uint64_t a, uint64_t b)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+      uint64_t high = 0;
+      const uint64_t low = _umul128(a, b, &high);
+      return low ^ high;
+#else
+      const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+      return uint64_t(product) ^ uint64_t(product >> 64);
+#endif
+    }
+
+    uint64_t read64(const char *bytes)
+    {
+      uint64_t value;
+      std::memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+
+    std::filesystem::path executable_path()
+    {
+#if defined(WINDOWS)
+      wchar_t path[MAX_PATH];
+      const DWORD size = GetModuleFileNameW(nullptr, path, MAX_PATH);
+      return (size > 0 && size < MAX_PATH) ? std::filesystem::path(path) : std::filesystem::path();
+#elif defined(MACOSX)
+      char path[4096];
+      uint32_t size = sizeof(path);
+      return (_NSGetExecutablePath(path, &size) == 0) ? std::filesystem::path(path) : std::filesystem::path();
+#else
+      return "/proc/self/exe";
+#endif
+    }
+
+    std::filesystem::path entry_path(const std::filesystem::path &directory, const key &k)
+    {
+      const std::string name = k.hex();
+
+      // 256 sub-directories, so that no directory grows too large
+      return directory / name.substr(0, 2) / name.substr(2);
+    }
+  }
+
+  std::string key::hex() const
+  {
+    constexpr const char *digits = "0123456789abcdef";
+
+    std::string str(32, '0');
+    for (size_t i = 0; i < 16; ++i)
+    {
+      str[15 - i] = digits[(high >> (i * 4)) & 0xF];
+      str[31 - i] = digits[(low >> (i * 4)) & 0xF];
+    }
+    return str;
+  }
+
+  // Two independent lanes of 16 bytes, each one multiplied into its accumulator
+  key hash(std::string_view bytes, uint64_t seed)
+  {
+    uint64_t a = seed ^ secret[0];
+    uint64_t b = seed ^ secret[1];
+
+    const char *data = bytes.data();
+    size_t size = bytes.size();
+
+    const auto round = [&a, &b](const char *block)
+    {
+      a = fold_multiply(read64(block) ^ secret[2], read64(block + 8) ^ a);
+      b = fold_multiply(read64(block + 16) ^ secret[3], read64(block + 24) ^ b);
+    };
+
+    for (; size >= 32; data += 32, size -= 32)
+      round(data);
+
+    if (size > 0)
+    {
+      char last[32] = {};
+      std::memcpy(last, data, size);
+      round(last);
+    }
+
+    a ^= bytes.size();
+
+    key k;
+    k.low = fold_multiply(a ^ secret[0], b ^ secret[3]);
+    k.high = fold_multiply(b ^ secret[1], k.low ^ secret[2]);
+    return k;
+  }
+
+  const std::string &build_id()
+  {
+    static const std::string id = []()
+    {
+      try
+      {
+        const aoc::input executable(executable_path());
+        return hash(executable.view()).hex();
+      }
+      catch (std::string &)
+      {
+        // still tells builds apart, as long as this file was rebuilt with the solvers
+        return hash(__DATE__ " " __TIME__).hex();
+      }
+    }();
+    return id;
+  }
+
+  key entry_key(std::string_view name, std::string_view input)
+  {
+    const std::string seed = std::string(name) + '\0' + build_id();
+    return hash(input, hash(seed).low);
+  }
+
+  std::optional<std::vector<std::string>> load(const std::filesystem::path &directory, const key &k)
+  {
+    std::ifstream file(entry_path(directory, k), std::ios::binary);
+    if (!file)
+      return std::nullopt;
+
+    std::vector<std::string> answers;
+    std::string line;
+    while (std::getline(file, line))
+      answers.push_back(line);
+
+    if (file.bad())
+      return std::nullopt;
+    return answers;
+  }
+
+  void save(const std::filesystem::path &directory, const key &k, const std::vector<std::string> &answers)
+  {
+    const std::filesystem::path path = entry_path(directory, k);
+
+    std::error_code err;
+    std::filesystem::create_directories(path.parent_path(), err);
+    if (err)
+      throw "Can't create cache directory '" + path.parent_path().string() + "': " + err.message();
+
+    // a name of its own for every writer, the rename then replaces the entry at once
+    static std::atomic<uint64_t> counter = 0;
+    const uint64_t unique = uint64_t(std::chrono::steady_clock::now().time_since_epoch().count())
+      ^ uint64_t(std::hash<std::thread::id>()(std::this_thread::get_id())) ^ (counter++ << 48);
+    const std::filesystem::path temporary = path.string() + '.' + hash(std::to_string(unique)).hex().substr(0, 8) + ".tmp";
+
+    {
+      std::ofstream file(temporary, std::ios::binary);
+      for (const std::string &line : answers)
+        file << line << '\n';
+
+      if (!file)
+      {
+        file.close();
+        std::filesystem::remove(temporary, err);
+        throw "Can't write cache entry '" + temporary.string() + "'";
+      }
+    }
+
+    std::filesystem::rename(temporary, path, err);
+    if (err)
+    {
+      const std::string reason = err.message();
+      std::filesystem::remove(temporary, err);
+      throw "Can't write cache entry '" + path.string() + "': " + reason;
+    }
+  }
+}
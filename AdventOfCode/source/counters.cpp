@@ -0,0 +1,150 @@
+#include "AdventOfCode.hpp"
+
+#include "counters.hpp"
+
+#ifdef LINUX
+# include <unistd.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <linux/perf_event.h>
+#endif
+
+namespace aoc::perf
+{
+  namespace
+  {
+    std::atomic<bool> counting = false;
+
+#ifdef LINUX
+    constexpr uint64_t configs[event_count] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    // The counters of one thread, the first one opened leads the group
+    class group
+    {
+    public:
+      group()
+      {
+        for (size_t i = 0; i < event_count; ++i)
+        {
+          perf_event_attr attr = {};
+          attr.size = sizeof(attr);
+          attr.type = PERF_TYPE_HARDWARE;
+          attr.config = configs[i];
+          attr.disabled = (m_leader == -1);
+          attr.exclude_kernel = 1; // allowed up to perf_event_paranoid 2
+          attr.exclude_hv = 1;
+          attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+          const int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, m_leader, 0));
+          if (fd == -1)
+          {
+            // a missing event is skipped, the others are still worth reading
+            const int err = errno;
+            if (m_error.empty())
+            {
+              m_error = std::string("perf_event_open: ") + std::strerror(err) + " (" + event_names[i] + ')';
+              if (err == EACCES || err == EPERM)
+                m_error += ", see /proc/sys/kernel/perf_event_paranoid";
+            }
+            continue;
+          }
+
+          if (m_leader == -1)
+            m_leader = fd;
+          m_fds[m_count] = fd;
+          m_events[m_count++] = event(i);
+        }
+
+        if (m_leader == -1)
+          return;
+
+        m_error.clear();
+        ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      }
+
+      ~group()
+      {
+        for (size_t i = 0; i < m_count; ++i)
+          close(m_fds[i]);
+      }
+
+      group(const group &) = delete;
+      group &operator=(const group &) = delete;
+
+      sample read() const
+      {
+        sample result;
+        if (m_leader == -1)
+          return result;
+
+        // { nr, time enabled, time running, one value per event in opening order }
+        uint64_t data[3 + event_count];
+        if (::read(m_leader, data, sizeof(data)) < ssize_t(3 * sizeof(uint64_t)))
+          return result;
+
+        const uint64_t enabled = data[1];
+        const uint64_t running = data[2];
+        for (size_t i = 0; i < data[0] && i < m_count; ++i)
+        {
+          // the kernel shares the counters between groups by time slices, extrapolate to the whole time
+          uint64_t value = data[3 + i];
+          if (running && running < enabled)
+            value = uint64_t(double(value) * double(enabled) / double(running));
+
+          result.values[m_events[i]] = value;
+          result.available |= 1u << m_events[i];
+        }
+        return result;
+      }
+
+      const std::string &error() const { return m_error; }
+
+    private:
+      int         m_leader = -1;
+      int         m_fds[event_count] = {};
+      event       m_events[event_count] = {};
+      size_t      m_count = 0;
+      std::string m_error;
+    };
+
+    group &thread_group()
+    {
+      thread_local group counters;
+      return counters;
+    }
+#endif
+  }
+
+  void enable()
+  {
+    counting = true;
+  }
+
+  bool enabled()
+  {
+    return counting;
+  }
+
+  sample read()
+  {
+#ifdef LINUX
+    if (counting)
+      return thread_group().read();
+#endif
+    return sample();
+  }
+
+  std::string error()
+  {
+#ifdef LINUX
+    return thread_group().error();
+#else
+    return "hardware counters are only read on Linux";
+#endif
+  }
+}
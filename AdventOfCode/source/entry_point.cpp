@@ -4,21 +4,98 @@
 
 #include "AdventOfCode.hpp"
 
-#include "timer.hpp"
+#include "Timer.hpp"
+#include "stats.hpp"
 #include "Output.hpp"
+#include "results.hpp"
+#include "generate.hpp"
+#include "shard.hpp"
+#include "serve.hpp"
+#include "cache.hpp"
 
 #include <cerrno>
 #include <chrono>
+#include <random>
+#include <thread>
 #include <cassert>
+#include <charconv>
 #include <iostream>
 
 using ss = std::stringstream;
 
-aoc::output aoc::cout;
+thread_local aoc::output aoc::cout;
+
+// memory of the aoc::pmr containers of the run in progress on this thread
+static thread_local aoc::arena run_arena;
 
 constexpr int l_margin = 1;
 constexpr int r_margin = 3;
 
+constexpr unsigned default_warmup = 3;
+constexpr double   default_threshold = 10;
+
+// a sweep times every size this many times when not benchmarking
+constexpr unsigned default_sweep_runs = 5;
+// growth exponent from which a problem is reported as superlinear
+constexpr double   superlinear_exponent = 1.5;
+
+enum class cache_policy
+{
+  use,    // answers of the cache when it has them
+  bypass, // always solve, and replace the entries
+  verify  // always solve, and fail when an entry holds other answers
+};
+
+struct options
+{
+  std::vector<const aoc::problem *> problems;
+  unsigned jobs = 1;
+
+  // input of the problems instead of their own "assets/input.txt", "-" for the standard input
+  std::filesystem::path input;
+  bool                  input_copied = false; // from the standard input, to a file removed once done
+
+  // directory of inputs, or file listing them, to solve concurrently with a single problem
+  std::filesystem::path batch;
+  // directory of the answers cached from one run to the next, if any
+  std::filesystem::path cache;
+  cache_policy          cache_mode = cache_policy::use;
+
+  // socket to answer requests on, instead of running the problems
+  std::filesystem::path serve;
+
+  // solve the batch in worker processes instead of the pool threads
+  bool                  sharded = false;
+  unsigned              processes = 0; // 0: one per core
+
+  // benchmark mode: untimed warmup runs, then timed repetitions
+  bool     bench = false;
+  unsigned warmup = 0;
+  unsigned repetitions = 1;
+
+  // count the allocations of the solvers
+  bool memory = false;
+
+  // read the hardware counters around the solvers
+  bool counters = false;
+
+  // where to write the timeline of the runs, if anywhere
+  std::filesystem::path trace;
+
+  // machine readable results, "-" for the standard output instead of the boxes
+  std::filesystem::path              results;
+  std::optional<aoc::results::format> results_format;
+
+  // previous results to compare the median times with, and the slowdown (in percent) reported as a regression
+  std::filesystem::path compare;
+  double                threshold = default_threshold;
+
+  // number of input sizes of a scaling sweep, 0 for a regular run
+  unsigned sweep = 0;
+};
+
+using aoc::result;
+
 static void print_centered(const std::string &str, size_t width)
 {
   width += l_margin + r_margin;
@@ -49,55 +126,1159 @@ static void print_left(const std::string &str, size_t width)
     << "|\n";
 }
 
-static void display_result(uint64_t micros)
+static std::string format_time(double micros)
 {
   const char *unit = "seconds";
-  double time = double(micros / 1'000'000.0);
+  double time = micros / 1'000'000.0;
 
   if (micros < 10'000)
   {
     unit = "milliseconds";
-    time = double(micros / 1'000.0);
+    time = micros / 1'000.0;
+  }
+
+  return (ss() << std::setprecision(3) << time << ' ' << unit).str();
+}
+
+static std::string format_bytes(size_t bytes)
+{
+  constexpr const char *units[] = { "B", "KB", "MB", "GB", "TB" };
+
+  size_t unit = 0;
+  double size = double(bytes);
+  while (size >= 1024 && unit + 1 < std::size(units))
+  {
+    size /= 1024;
+    ++unit;
+  }
+
+  return (ss() << std::setprecision(3) << size << ' ' << units[unit]).str();
+}
+
+// 1234567 -> "1.23M"
+static std::string format_count(uint64_t count)
+{
+  constexpr const char *units[] = { "", "K", "M", "G", "T" };
+
+  size_t unit = 0;
+  double value = double(count);
+  while (value >= 1000 && unit + 1 < std::size(units))
+  {
+    value /= 1000;
+    ++unit;
+  }
+
+  return (ss() << std::setprecision(3) << value << units[unit]).str();
+}
+
+static std::string format_counters(const aoc::perf::sample &counters)
+{
+  ss out;
+
+  for (size_t i = 0; i < aoc::perf::event_count; ++i)
+  {
+    const aoc::perf::event e = aoc::perf::event(i);
+    if (!counters.has(e))
+      continue;
+
+    if (out.tellp() > 0)
+      out << ", ";
+    out << format_count(counters.values[e]) << ' ' << aoc::perf::event_names[e];
+
+    if (e == aoc::perf::instructions && counters.has(aoc::perf::cycles))
+      out << " (IPC " << std::fixed << std::setprecision(2) << counters.ipc() << std::defaultfloat << ')';
+  }
+  return out.str();
+}
+
+static std::string format_usage(const aoc::memory::usage &usage)
+{
+  return (ss() << usage.allocations << (usage.allocations == 1 ? " allocation, " : " allocations, ") << format_bytes(usage.bytes) << ", peak " << format_bytes(usage.peak)).str();
+}
+
+static std::string format_short_time(double micros)
+{
+  ss out;
+
+  out << std::setprecision(3);
+  if (micros < 1'000)
+    out << micros << "us";
+  else if (micros < 1'000'000)
+    out << micros / 1'000 << "ms";
+  else
+    out << micros / 1'000'000 << 's';
+  return out.str();
+}
+
+// One line per parent phase: "parse 41us / part 1 3us / part 2 1.2ms"
+// The children of a phase are listed on an indented line below it
+static void format_phases(aoc::output &out, const std::vector<aoc::phase> &phases, size_t parent = aoc::phase::npos)
+{
+  std::vector<size_t> children;
+  for (size_t i = 0; i < phases.size(); ++i)
+    if (phases[i].parent == parent)
+      children.push_back(i);
+
+  if (children.empty())
+    return;
+
+  if (parent != aoc::phase::npos)
+    out << std::string(phases[parent].depth * 2 + 2, ' ') << phases[parent].name << ": ";
+
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    const aoc::phase &phase = phases[children[i]];
+
+    if (i > 0)
+      out << " / ";
+    out << phase.name << ' ' << format_short_time(phase.micros);
+    if (phase.calls > 1)
+      out << " (x" << phase.calls << ')';
   }
+  out << '\n';
 
-  const std::string HEADER  = (PROJECT_NAME " : " + aoc::ProblemName());
-  const std::string SUMMARY = (ss() << "Problem solved in " << std::setprecision(3) << time << ' ' << unit).str();
+  for (size_t child : children)
+    format_phases(out, phases, child);
+}
 
-  aoc::cout.flush();
+// "memory : 1234 allocations, 5.21 MB, peak 1.1 MB", then the same for each phase, indented by depth
+static void format_memory(aoc::output &out, const result &res)
+{
+  if (aoc::memory::counts_allocations())
+  {
+    out << "memory : " << format_usage(res.memory) << '\n';
+    for (const aoc::phase &phase : res.phases)
+      out << std::string(phase.depth * 2 + 2, ' ') << phase.name << " : " << format_usage(phase.memory) << '\n';
+  }
+  out << "peak RSS : " << format_bytes(res.peak_rss) << '\n';
+}
+
+// "counters : 1.2M cycles, 3.1M instructions (IPC 2.58), ...", then the same for each phase, indented by depth
+static void format_hardware_counters(aoc::output &out, const result &res)
+{
+  if (res.counters.empty())
+  {
+    out << "counters : unavailable, " << aoc::perf::error() << '\n';
+    return;
+  }
+
+  out << "counters : " << format_counters(res.counters) << '\n';
+  for (const aoc::phase &phase : res.phases)
+    out << std::string(phase.depth * 2 + 2, ' ') << phase.name << " : " << format_counters(phase.counters) << '\n';
+}
+
+static void display_box(const std::string &header, aoc::output &output, const std::string &summary, aoc::output *details = nullptr)
+{
+  output.flush();
 
-  size_t width = aoc::cout.width();
-  if (SUMMARY.size() > width)
-    width = SUMMARY.size();
+  size_t width = output.width();
+  if (details)
+  {
+    details->flush();
+    width = std::max(width, details->width());
+  }
+  if (summary.size() > width)
+    width = summary.size();
+  if (header.size() > width)
+    width = header.size();
 
   const std::string border(width + l_margin + r_margin, '-');
 
   // header
   std::cout << '+' << border << "+\n";
-  print_centered(HEADER, width);
+  print_centered(header, width);
 
   // problem solver output
   std::cout << '+' << border << "+\n";
   print_left("", width);
-  for (const std::string &line : aoc::cout)
+  for (const std::string &line : output)
     print_left(line, width);
-  if (aoc::cout)
+  if (output)
     print_left("", width);
 
+  // additional information about the run
+  if (details)
+  {
+    std::cout << '+' << border << "+\n";
+    for (const std::string &line : *details)
+      print_left(line, width);
+  }
+
   // summary
   std::cout << '+' << border << "+\n";
-  print_centered(SUMMARY, width);
+  print_centered(summary, width);
   std::cout << '+' << border << "+\n";
 }
 
-int main()
+static void display_result(result &res, const options &opts)
+{
+  const std::string HEADER = (PROJECT_NAME " : " + res.problem->name);
+
+  if (res.cached)
+  {
+    display_box(HEADER, res.output, "Answers read from the cache in " + format_time(res.stats.median));
+    return;
+  }
+
+  aoc::output details;
+  format_phases(details, res.phases);
+
+  if (opts.memory)
+  {
+    if (!res.phases.empty())
+      details << '\n';
+    format_memory(details, res);
+  }
+
+  if (opts.counters)
+  {
+    if (!res.phases.empty() || opts.memory)
+      details << '\n';
+    format_hardware_counters(details, res);
+  }
+
+  if (!opts.bench)
+  {
+    const bool has_details = !res.phases.empty() || opts.memory || opts.counters;
+    display_box(HEADER, res.output, "Problem solved in " + format_time(res.stats.median), has_details ? &details : nullptr);
+    return;
+  }
+
+  const aoc::stats &stats = res.stats;
+  const std::string SUMMARY = (ss() << "Problem solved in " << format_time(stats.median) << " (median of " << stats.count << " runs)").str();
+
+  if (!res.phases.empty() || opts.memory || opts.counters)
+    details << '\n';
+  details << "min    : " << format_time(stats.min) << '\n';
+  details << "median : " << format_time(stats.median) << '\n';
+  details << "p90    : " << format_time(stats.p90) << '\n';
+  details << "p99    : " << format_time(stats.p99) << '\n';
+  details << "max    : " << format_time(stats.max) << '\n';
+  details << "stddev : " << format_time(stats.stddev) << '\n';
+
+  display_box(HEADER, res.output, SUMMARY, &details);
+}
+
+static void display_summary(const std::vector<result> &results, double micros)
 {
+  aoc::output output;
+
+  for (const result &res : results)
+  {
+    output << res.problem->name << " : ";
+    if (!res.error.empty())
+      output << "failed";
+    else
+      output << format_time(res.stats.median) << (res.cached ? " (cached)" : "");
+    output << '\n';
+  }
+
+  const std::string SUMMARY = (ss() << results.size() << " problems solved in " << format_time(micros)).str();
+
+  display_box(PROJECT_NAME, output, SUMMARY);
+}
+
+static void write_results(std::vector<result> &results, const options &opts)
+{
+  if (opts.results == "-")
+  {
+    aoc::results::write(std::cout, results, opts.results_format.value_or(aoc::results::format::json));
+    return;
+  }
+
+  std::ofstream file(opts.results);
+  if (!file)
+    throw "Can't open results file '" + opts.results.string() + "': " + std::strerror(errno);
+
+  aoc::results::write(file, results, opts.results_format.value_or(aoc::results::format_of(opts.results)));
+}
+
+// One line per problem: "Day 07 : 1.21 milliseconds -> 1.35 milliseconds (+11.6%) REGRESSED"
+// Returns the number of problems slower than `threshold` percent
+static size_t display_comparison(const std::vector<result> &results, const options &opts)
+{
+  const std::map<std::string, double> previous = aoc::results::read_medians(opts.compare);
+
+  aoc::output output;
+  size_t regressions = 0;
+
+  for (const result &res : results)
+  {
+    // a cached result only timed the cache read
+    if (res.cached)
+    {
+      output << res.problem->name << " : cached, not timed\n";
+      continue;
+    }
+
+    const auto it = previous.find(res.problem->name);
+    if (!res.error.empty() || it == previous.end() || it->second <= 0)
+    {
+      output << res.problem->name << " : " << (res.error.empty() ? "no previous result" : "failed") << '\n';
+      continue;
+    }
+
+    const double change = (res.stats.median / it->second - 1) * 100;
+
+    output << res.problem->name << " : " << format_time(it->second) << " -> " << format_time(res.stats.median)
+      << " (" << std::showpos << std::setprecision(3) << change << std::noshowpos << "%)";
+    if (change > opts.threshold)
+    {
+      output << " REGRESSED";
+      ++regressions;
+    }
+    output << '\n';
+  }
+
+  const std::string SUMMARY = (ss() << regressions << " regression(s) over " << opts.threshold << '%').str();
+
+  // the standard output only holds the results when they are written there
+  if (opts.results == "-")
+  {
+    output.flush();
+    for (const std::string &line : output)
+      std::cerr << line << '\n';
+    std::cerr << SUMMARY << std::endl;
+  }
+  else
+    display_box("Compared with " + opts.compare.string(), output, SUMMARY);
+  return regressions;
+}
+
+// The runner starts from the workspace root, day executables from their own folder
+static std::filesystem::path find_input(const aoc::problem &problem)
+{
+  const std::filesystem::path local = std::filesystem::path(problem.name) / "assets" / "input.txt";
+
+  if (std::filesystem::exists(local))
+    return local;
+  return std::filesystem::path("assets") / "input.txt";
+}
+
+// Returns the time taken by the solver in microseconds.
+// The heap usage of the run (with a tracker) and its hardware counters are stored in `res`
+static double run_once(const aoc::problem &problem, const aoc::context &ctx, aoc::memory::tracker *tracker, result &res)
+{
+  // only keep the output of the last run
+  aoc::cout.clear();
+  aoc::profiler.clear();
+
+  // the previous run's containers are all gone
+  run_arena.reset();
+  aoc::arena_scope scope(run_arena);
+
+  aoc::memory::scope tracking(tracker);
+  const aoc::memory::tracker::mark start = tracker ? tracker->begin() : aoc::memory::tracker::mark();
+
+  const aoc::perf::sample counters = aoc::perf::read();
+  aoc::trace::span span(problem.name, "run");
+  aoc::timer timer;
+  problem.solve(ctx);
+  const double micros = timer.GetTime<double, std::micro>();
+  res.counters = aoc::perf::read() - counters;
+
+  if (tracker)
+    res.memory = tracker->end(start);
+  return micros;
+}
+
+// Phases are matched by position, a run going through different phases than the first one is not recorded
+static void record_phases(result &res, std::vector<std::vector<double>> &samples)
+{
+  const std::vector<aoc::phase> &phases = aoc::profiler.phases();
+
+  if (samples.empty())
+  {
+    res.phases = phases;
+    samples.resize(phases.size());
+  }
+
+  if (phases.size() != res.phases.size())
+    return;
+
+  for (size_t i = 0; i < phases.size(); ++i)
+  {
+    samples[i].push_back(phases[i].micros);
+    // like the run's own, these come from the last run
+    res.phases[i].memory = phases[i].memory;
+    res.phases[i].counters = phases[i].counters;
+  }
+}
+
+// A path of the temporary directory for this run only: `name` followed by random digits
+static std::filesystem::path unique_temp_path(std::string_view name)
+{
+  static std::mt19937_64 rng(std::random_device{}() ^ uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+  std::ostringstream unique;
+  unique << name << '-' << std::hex << std::setw(16) << std::setfill('0') << rng();
+  return std::filesystem::temp_directory_path() / unique.str();
+}
+
+// Removes a temporary file or directory, and whatever it holds, on every way out of its scope
+class temp_path
+{
+public:
+  explicit temp_path(std::filesystem::path path = {}) : m_path(std::move(path)) {}
+  ~temp_path()
+  {
+    std::error_code ignored;
+    if (!m_path.empty())
+      std::filesystem::remove_all(m_path, ignored);
+  }
+
+  temp_path(const temp_path &) = delete;
+  temp_path &operator=(const temp_path &) = delete;
+
+  const std::filesystem::path &path() const { return m_path; }
+
+private:
+  std::filesystem::path m_path;
+};
+
+// The solvers map their input file and read it once per run: the standard input is copied to a file first
+static std::filesystem::path save_stdin()
+{
+  std::filesystem::path path;
+  std::FILE *file = nullptr;
+
+  // created only if it does not exist yet: concurrent runs never share their copy
+  for (int attempt = 0; !file && attempt < 16; ++attempt)
+  {
+    path = unique_temp_path("aoc-stdin");
+    file = std::fopen(path.string().c_str(), "wbx");
+  }
+  if (!file)
+    throw "Can't create '" + path.string() + "': " + std::strerror(errno);
+
+  char buffer[1 << 16];
+  size_t count = 0;
+  bool written = true;
+  while (written && (count = std::fread(buffer, 1, sizeof(buffer), stdin)) > 0)
+    written = (std::fwrite(buffer, 1, count, file) == count);
+
+  const bool read = !std::ferror(stdin);
+  written = (std::fclose(file) == 0) && written;
+
+  if (!read || !written)
+  {
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+    throw read ? "Can't write '" + path.string() + "'" : std::string("Can't read the standard input");
+  }
+  return path;
+}
+
+static result run(const aoc::problem &problem, const std::filesystem::path &input, const options &opts)
+{
+  result res;
+  res.problem = &problem;
+
+  const aoc::context ctx { problem, input };
+
+  aoc::memory::tracker tracker;
+  aoc::memory::tracker *tracked = opts.memory ? &tracker : nullptr;
+
+  try
+  {
+    for (unsigned i = 0; i < opts.warmup; ++i)
+      run_once(problem, ctx, tracked, res);
+
+    std::vector<double> samples;
+    std::vector<std::vector<double>> phase_samples;
+
+    samples.reserve(opts.repetitions);
+    for (unsigned i = 0; i < opts.repetitions; ++i)
+    {
+      samples.push_back(run_once(problem, ctx, tracked, res));
+      record_phases(res, phase_samples);
+    }
+
+    res.stats = aoc::stats::compute(std::move(samples));
+    for (size_t i = 0; i < res.phases.size(); ++i)
+      res.phases[i].micros = aoc::stats::compute(std::move(phase_samples[i])).median;
+
+    // of the whole process: it includes the problems that ran before and alongside this one
+    if (opts.memory)
+      res.peak_rss = aoc::memory::peak_rss();
+  }
+  catch (std::string &err)
+  {
+    res.error = err;
+  }
+  catch (const char *err)
+  {
+    res.error = err;
+  }
+  catch (std::exception &err)
+  {
+    res.error = err.what();
+  }
+
+  // hand the buffered output over to the result, this thread may run another problem next
+  res.output = std::exchange(aoc::cout, aoc::output());
+  return res;
+}
+
+// The answers of the cache when it has them. Otherwise, or when it is bypassed or verified, the problem is run
+// and its answers stored. A hit is timed from the opening of the input to the reading of the entry
+static result run_cached(const aoc::problem &problem, const std::filesystem::path &input, const options &opts)
+{
+  if (opts.cache.empty())
+    return run(problem, input, opts);
+
+  aoc::timer timer;
+  aoc::cache::key key;
+  std::optional<std::vector<std::string>> answers;
+
+  try
+  {
+    const aoc::input bytes(input);
+
+    key = aoc::cache::entry_key(problem.name, bytes.view());
+    if (opts.cache_mode != cache_policy::bypass)
+      answers = aoc::cache::load(opts.cache, key);
+  }
+  catch (std::string &err)
+  {
+    result res;
+    res.problem = &problem;
+    res.error = err;
+    return res;
+  }
+
+  if (answers && opts.cache_mode == cache_policy::use)
+  {
+    result res;
+    res.problem = &problem;
+    res.cached = true;
+    for (const std::string &line : *answers)
+      res.output << line << '\n';
+    res.stats = aoc::stats::compute({ timer.GetTime<double, std::micro>() });
+    return res;
+  }
+
+  result res = run(problem, input, opts);
+  if (!res.error.empty())
+    return res;
+
+  res.output.flush();
+  const std::vector<std::string> lines(res.output.begin(), res.output.end());
+
+  if (answers && lines != *answers)
+  {
+    res.error = "The answers differ from the cache entry " + key.hex();
+    return res;
+  }
+
   try
   {
-    init();
+    if (!answers)
+      aoc::cache::save(opts.cache, key, lines);
+  }
+  catch (std::string &err)
+  {
+    res.error = err;
+  }
+  return res;
+}
+
+static std::vector<result> run_all(const options &opts)
+{
+  std::vector<result> results(opts.problems.size());
+
+  // one problem per chunk, the solvers' own parallel loops share the same pool
+  aoc::exec::parallel_for(size_t(0), results.size(), [&opts, &results](size_t i)
+  {
+    const aoc::problem &problem = *opts.problems[i];
+    results[i] = run_cached(problem, opts.input.empty() ? find_input(problem) : opts.input, opts);
+  }, 1, opts.jobs);
+
+  return results;
+}
+
+// The files of a directory, sorted, or the paths listed in a file, one per line
+static std::vector<std::filesystem::path> batch_inputs(const std::filesystem::path &source)
+{
+  std::vector<std::filesystem::path> inputs;
+
+  if (std::filesystem::is_directory(source))
+  {
+    for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(source))
+      if (entry.is_regular_file())
+        inputs.push_back(entry.path());
+
+    std::sort(inputs.begin(), inputs.end());
+    return inputs;
+  }
+
+  std::ifstream file(source);
+  if (!file)
+    throw "Can't open batch list '" + source.string() + "': " + std::strerror(errno);
+
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (!line.empty())
+      inputs.push_back(line);
+  }
+  return inputs;
+}
+
+// What a worker process sends back: a line of statistics and memory usage followed by the answers, or the error
+static std::string pack_result(result &res)
+{
+  if (!res.error.empty())
+    return "error\n" + res.error;
+
+  const aoc::stats &s = res.stats;
+  ss out;
+  out << std::setprecision(17)
+    << s.count << ' ' << s.min << ' ' << s.median << ' ' << s.p90 << ' ' << s.p99 << ' ' << s.max << ' ' << s.mean << ' ' << s.stddev << ' '
+    << res.memory.allocations << ' ' << res.memory.bytes << ' ' << res.memory.peak << ' ' << res.peak_rss << ' ' << res.cached << '\n';
+
+  res.output.flush();
+  for (const std::string &line : res.output)
+    out << line << '\n';
+  return out.str();
+}
+
+static void unpack_result(std::string_view payload, bool truncated, result &res)
+{
+  if (payload.empty())
+  {
+    res.error = "the worker process died";
+    return;
+  }
+  // what is left could pass for answers, or for another error
+  if (truncated)
+  {
+    res.error = "the result is longer than the " + std::to_string(aoc::shard::payload_capacity) + " bytes a worker process can send back";
+    return;
+  }
+
+  std::istringstream in { std::string(payload) };
+  std::string line;
+  std::getline(in, line);
+
+  if (line == "error")
+  {
+    res.error = std::string(payload.substr(line.size() + 1));
+    return;
+  }
+
+  aoc::stats &s = res.stats;
+  std::istringstream(line)
+    >> s.count >> s.min >> s.median >> s.p90 >> s.p99 >> s.max >> s.mean >> s.stddev
+    >> res.memory.allocations >> res.memory.bytes >> res.memory.peak >> res.peak_rss >> res.cached;
+
+  while (std::getline(in, line))
+    res.output << line << '\n';
+}
+
+// Solves every input of the batch on the pool, or in worker processes. Each thread keeps its arena from one input
+// to the next, once warmed up the pmr containers make no heap call. Returns the number of failed inputs
+static size_t run_batch(const options &opts)
+{
+  const aoc::problem &problem = *opts.problems.front();
+  const std::vector<std::filesystem::path> inputs = batch_inputs(opts.batch);
+
+  std::vector<result> results(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i)
+  {
+    results[i].problem = &problem;
+    results[i].input = inputs[i].string();
+  }
 
-    aoc::timer timer;
-    solve();
-    display_result(timer.GetTime<std::chrono::microseconds>());
+  aoc::timer timer;
+  if (opts.sharded)
+  {
+    // the phases and counters stay in the workers
+    aoc::shard::run(inputs.size(), opts.processes, [&problem, &inputs, &opts](size_t i)
+    {
+      result res = run_cached(problem, inputs[i], opts);
+      return pack_result(res);
+    },
+    [&results](size_t i, std::string_view payload, bool truncated)
+    {
+      unpack_result(payload, truncated, results[i]);
+    });
+  }
+  else
+  {
+    aoc::exec::parallel_for(size_t(0), inputs.size(), [&problem, &inputs, &opts, &results](size_t i)
+    {
+      results[i] = run_cached(problem, inputs[i], opts);
+      results[i].input = inputs[i].string();
+    }, 1, opts.jobs);
+  }
+  const double micros = timer.GetTime<double, std::micro>();
+
+  uintmax_t bytes = 0;
+  for (const std::filesystem::path &input : inputs)
+  {
+    std::error_code ignored;
+    const uintmax_t size = std::filesystem::file_size(input, ignored);
+    if (size != uintmax_t(-1))
+      bytes += size;
+  }
+
+  // "inputs/07.txt : 3749 | 11387 (41.2us)"
+  aoc::output output;
+  size_t failed = 0;
+  for (result &res : results)
+  {
+    output << res.input << " : ";
+    if (!res.error.empty())
+    {
+      output << "failed, " << res.error << '\n';
+      ++failed;
+      continue;
+    }
+
+    res.output.flush();
+    bool first = true;
+    for (const std::string &line : res.output)
+    {
+      output << (first ? "" : " | ") << line;
+      first = false;
+    }
+    output << " (" << format_short_time(res.stats.median) << (res.cached ? ", cached" : "") << ")\n";
+  }
+
+  const double seconds = micros / 1'000'000;
+  const std::string SUMMARY = (ss() << std::setprecision(3)
+    << inputs.size() << " inputs solved in " << format_time(micros) << " ("
+    << double(inputs.size()) / seconds << " inputs/s, " << double(bytes) / 1'000'000 / seconds << " MB/s)").str();
+
+  if (opts.results != "-")
+    display_box(PROJECT_NAME " : " + problem.name + " batch", output, SUMMARY);
+  else
+    std::cerr << SUMMARY << std::endl;
+
+  if (!opts.results.empty())
+    write_results(results, opts);
+  if (!opts.trace.empty())
+    aoc::trace::write(opts.trace);
+  return failed;
+}
+
+// One input size of a scaling sweep
+struct sweep_point
+{
+  size_t size;   // in the unit of the generator
+  size_t bytes;  // of the input file
+  double micros; // median run time
+  size_t peak;   // peak heap and arena usage of the run
+};
+
+// Slope of the least squares line through (log x, log y): y grows as x^k
+template<class Y>
+static double fit_exponent(const std::vector<sweep_point> &points, Y y)
+{
+  double mean_x = 0;
+  double mean_y = 0;
+  for (const sweep_point &point : points)
+  {
+    mean_x += std::log(double(point.bytes));
+    mean_y += std::log(y(point));
+  }
+  mean_x /= double(points.size());
+  mean_y /= double(points.size());
+
+  double covariance = 0;
+  double variance = 0;
+  for (const sweep_point &point : points)
+  {
+    const double dx = std::log(double(point.bytes)) - mean_x;
+    covariance += dx * (std::log(y(point)) - mean_y);
+    variance += dx * dx;
+  }
+  return (variance > 0) ? covariance / variance : 0;
+}
+
+// Runs the problem on generated inputs from the size of a puzzle input, doubling the input at each step.
+// Returns the growth exponent of the run time, or a negative value when the sweep could not be done
+static double sweep(const aoc::problem &problem, const aoc::generate::generator &gen, const std::filesystem::path &directory, const options &opts, aoc::output &summary)
+{
+  aoc::output output;
+  std::vector<sweep_point> points;
+  std::string error;
+
+  for (unsigned step = 0; step < opts.sweep && error.empty(); ++step)
+  {
+    // a grid's side only grows by sqrt(2) for its input to double
+    const double growth = std::pow(gen.side ? std::sqrt(2.0) : 2.0, step);
+    const size_t size = size_t(std::llround(double(gen.puzzle_size) * growth));
+
+    const std::filesystem::path input = directory / (problem.name + ".txt");
+    {
+      std::ofstream file(input, std::ios::binary);
+      aoc::generate::write(gen, file, size, aoc::generate::default_seed);
+      if (!file)
+        throw "Can't write '" + input.string() + "'";
+    }
+
+    const result res = run(problem, input, opts);
+    const size_t bytes = size_t(std::filesystem::file_size(input));
+
+    output << size << ' ' << gen.unit << ", " << format_bytes(bytes) << " : ";
+    if (!res.error.empty())
+    {
+      error = res.error;
+      output << "failed, " << error << '\n';
+      break;
+    }
+
+    // after a warmup run, the arena holds every aoc::pmr container without a heap call
+    const size_t peak = res.memory.peak + run_arena.used();
+
+    points.push_back({ size, bytes, res.stats.median, peak });
+    output << format_time(res.stats.median) << ", peak " << format_bytes(peak) << '\n';
+  }
+
+  std::error_code ignored;
+  std::filesystem::remove(directory / (problem.name + ".txt"), ignored);
+
+  summary << problem.name << " : ";
+  if (!error.empty() || points.size() < 2)
+  {
+    summary << "failed\n";
+    display_box(PROJECT_NAME " : " + problem.name + " scaling", output, "Growth unknown");
+    return -1;
+  }
+
+  // small inputs are dominated by fixed costs, zero times or peaks don't fit on a log scale
+  const double time_exponent = fit_exponent(points, [](const sweep_point &p) { return std::max(p.micros, 0.01); });
+  const double memory_exponent = fit_exponent(points, [](const sweep_point &p) { return double(std::max<size_t>(p.peak, 1)); });
+
+  ss exponents;
+  exponents << std::fixed << std::setprecision(2) << "time ~ n^" << time_exponent << ", memory ~ n^" << memory_exponent;
+  if (time_exponent > superlinear_exponent)
+    exponents << " SUPERLINEAR";
+
+  summary << exponents.str() << '\n';
+  display_box(PROJECT_NAME " : " + problem.name + " scaling", output, exponents.str());
+  return time_exponent;
+}
+
+// Returns the number of superlinear problems, a failed sweep counts as one
+static size_t sweep_all(const options &opts)
+{
+  // of this run only: concurrent sweeps would write their inputs over each other's
+  std::filesystem::path path;
+  bool created = false;
+  for (int attempt = 0; attempt < 16 && !created; ++attempt)
+  {
+    std::error_code err;
+    path = unique_temp_path("aoc-sweep");
+    created = std::filesystem::create_directory(path, err);
+  }
+  if (!created)
+    throw std::string("Can't create a directory for the sweep inputs in ") + std::filesystem::temp_directory_path().string();
+
+  // removed even when a sweep throws
+  const temp_path directory(path);
+
+  aoc::output summary;
+  size_t flagged = 0;
+
+  // one problem at a time: problems running alongside would skew each other's growth
+  for (const aoc::problem *problem : opts.problems)
+  {
+    const aoc::generate::generator *gen = aoc::generate::find(problem->name);
+    if (!gen)
+    {
+      summary << problem->name << " : no generator\n";
+      continue;
+    }
+
+    const double exponent = sweep(*problem, *gen, directory.path(), opts, summary);
+    if (exponent < 0 || exponent > superlinear_exponent)
+      ++flagged;
+  }
+
+  const std::string SUMMARY = (ss() << flagged << " problem(s) growing faster than n^" << superlinear_exponent).str();
+  display_box(PROJECT_NAME " : scaling", summary, SUMMARY);
+  return flagged;
+}
+
+// Accepts "Day 01", "01" or "1"
+static const aoc::problem *find_problem(std::string_view name)
+{
+  unsigned number = 0;
+  const char *end = name.data() + name.size();
+  const bool numeric = (std::from_chars(name.data(), end, number).ptr == end);
+
+  for (const aoc::problem *problem : aoc::problems())
+  {
+    if (problem->name == name)
+      return problem;
+
+    if (!numeric)
+      continue;
+
+    const size_t pos = problem->name.find_last_not_of("0123456789") + 1;
+    const std::string_view suffix = std::string_view(problem->name).substr(pos);
+
+    unsigned problem_number = 0;
+    std::from_chars(suffix.data(), suffix.data() + suffix.size(), problem_number);
+    if (!suffix.empty() && problem_number == number)
+      return problem;
+  }
+  return nullptr;
+}
+
+// A request made to the server, on the thread of its connection
+static aoc::serve::response serve_request(std::string_view name, const std::filesystem::path &input, const options &opts)
+{
+  const aoc::problem *problem = find_problem(name);
+  if (!problem)
+    return { false, 0, "Unknown problem '" + std::string(name) + "'" };
+
+  result res = run_cached(*problem, input, opts);
+  if (!res.error.empty())
+    return { false, 0, res.error };
+
+  std::string answers;
+  res.output.flush();
+  for (const std::string &line : res.output)
+    answers += line + '\n';
+  return { true, res.stats.median, answers };
+}
+
+static void print_usage(const char *program)
+{
+  std::cout
+    << "Usage: " << program << " [options] [problem...]\n"
+    << "  Runs the given problems (\"Day 01\", \"01\" or \"1\"), or every registered problem.\n"
+    << "\n"
+    << "Options:\n"
+    << "  -i, --input <f>   input file of the problem instead of its assets/input.txt (\"-\": standard input)\n"
+    << "  -n, --repeat <n>  run each problem <n> times and report its median time\n"
+    << "      --batch <d>   solve every file of the directory <d> (or listed in the file <d>, one per line)\n"
+    << "                    with a single problem, concurrently, and report the throughput\n"
+    << "      --cache <d>   read the answers from the cache in <d> when the input was solved by this build before,\n"
+    << "                    store them there otherwise\n"
+    << "      --cache-bypass solve every problem, and replace the answers in the cache\n"
+    << "      --cache-verify solve every problem, and fail when the cache holds other answers\n"
+    << "      --serve <s>   answer the requests of aoc-client on the Unix socket <s>, with warm pools and arenas\n"
+    << "  -P, --processes <n> solve the batch in <n> worker processes pinned to their share of the cores (0: one per core)\n"
+    << "  -j, --jobs <n>    solve up to <n> problems concurrently (0: one per thread)\n"
+    << "  -t, --threads <n> size of the thread pool, the main thread included (0: one per core)\n"
+    << "  -b, --bench <n>   benchmark mode, time <n> runs of each problem\n"
+    << "  -w, --warmup <n>  untimed runs before benchmarking (default: " << default_warmup << ")\n"
+    << "  -m, --memory      count the allocations of each problem and phase, report the peak RSS\n"
+    << "  -c, --counters    read the hardware counters (cycles, instructions, cache and branch misses) of each problem and phase\n"
+    << "  -T, --trace <f>   write the timeline of the runs, phases and parallel chunks to <f> (chrome://tracing, Perfetto)\n"
+    << "  -r, --results <f> write the results to <f> (\"-\": standard output, instead of the boxes)\n"
+    << "  -f, --format <f>  format of the results: json (one object per line) or csv (default: from the extension)\n"
+    << "  -o, --output <f>  what to write on the standard output: boxes (default), json or csv (same as -r - -f <f>)\n"
+    << "      --compare <f> compare the median times with the results in <f>, fail on regressions\n"
+    << "      --threshold <p> slowdown reported as a regression, in percent (default: " << default_threshold << ")\n"
+    << "  -s, --sweep <n>   time each problem on <n> generated inputs, from the size of a puzzle input and doubling,\n"
+    << "                    fit the growth of its time and memory, fail on growths over n^" << superlinear_exponent << '\n'
+    << "  -h, --help        display this help\n";
+}
+
+static unsigned parse_count(int ac, char **av, int &i)
+{
+  const std::string_view arg = av[i];
+
+  if (++i >= ac)
+    throw "Missing value after " + std::string(arg);
+
+  unsigned value = 0;
+  const char *end = av[i] + std::strlen(av[i]);
+  if (std::from_chars(av[i], end, value).ptr != end)
+    throw "Invalid value '" + std::string(av[i]) + "' for " + std::string(arg);
+
+  return value;
+}
+
+static const char *parse_value(int ac, char **av, int &i)
+{
+  const std::string_view arg = av[i];
+
+  if (++i >= ac)
+    throw "Missing value after " + std::string(arg);
+  return av[i];
+}
+
+static aoc::results::format parse_format(std::string_view value)
+{
+  if (value == "json")
+    return aoc::results::format::json;
+  if (value == "csv")
+    return aoc::results::format::csv;
+  throw "Unknown results format '" + std::string(value) + "'";
+}
+
+static options parse_options(int ac, char **av)
+{
+  options opts;
+  bool warmup_set = false;
+  bool jobs_set = false;
+
+  for (int i = 1; i < ac; ++i)
+  {
+    const std::string_view arg = av[i];
+
+    if (arg == "-h" || arg == "--help")
+    {
+      print_usage(av[0]);
+      std::exit(0);
+    }
+    else if (arg == "-i" || arg == "--input")
+      opts.input = parse_value(ac, av, i);
+    else if (arg == "--batch")
+      opts.batch = parse_value(ac, av, i);
+    else if (arg == "--cache")
+      opts.cache = parse_value(ac, av, i);
+    else if (arg == "--cache-bypass")
+      opts.cache_mode = cache_policy::bypass;
+    else if (arg == "--cache-verify")
+      opts.cache_mode = cache_policy::verify;
+    else if (arg == "--serve")
+      opts.serve = parse_value(ac, av, i);
+    else if (arg == "-P" || arg == "--processes")
+    {
+      opts.processes = parse_count(ac, av, i);
+      opts.sharded = true;
+    }
+    else if (arg == "-n" || arg == "--repeat")
+      opts.repetitions = std::max(1u, parse_count(ac, av, i));
+    else if (arg == "-j" || arg == "--jobs")
+    {
+      opts.jobs = parse_count(ac, av, i);
+      jobs_set = true;
+    }
+    else if (arg == "-t" || arg == "--threads")
+      aoc::exec::set_threads(parse_count(ac, av, i));
+    else if (arg == "-b" || arg == "--bench")
+    {
+      opts.bench = true;
+      opts.repetitions = std::max(1u, parse_count(ac, av, i));
+    }
+    else if (arg == "-w" || arg == "--warmup")
+    {
+      opts.warmup = parse_count(ac, av, i);
+      warmup_set = true;
+    }
+    else if (arg == "-m" || arg == "--memory")
+      opts.memory = true;
+    else if (arg == "-T" || arg == "--trace")
+    {
+      opts.trace = parse_value(ac, av, i);
+      aoc::trace::enable();
+    }
+    else if (arg == "-r" || arg == "--results")
+      opts.results = parse_value(ac, av, i);
+    else if (arg == "-f" || arg == "--format")
+      opts.results_format = parse_format(parse_value(ac, av, i));
+    else if (arg == "-o" || arg == "--output")
+    {
+      const std::string_view value = parse_value(ac, av, i);
+
+      if (value == "boxes")
+        opts.results.clear();
+      else
+      {
+        opts.results_format = parse_format(value);
+        opts.results = "-";
+      }
+    }
+    else if (arg == "--compare")
+      opts.compare = parse_value(ac, av, i);
+    else if (arg == "--threshold")
+    {
+      const char *value = parse_value(ac, av, i);
+      char *end = nullptr;
+
+      opts.threshold = std::strtod(value, &end);
+      if (end == value || *end != '\0')
+        throw "Invalid value '" + std::string(value) + "' for " + std::string(arg);
+    }
+    else if (arg == "-s" || arg == "--sweep")
+      opts.sweep = std::max(2u, parse_count(ac, av, i));
+    else if (arg == "-c" || arg == "--counters")
+    {
+      opts.counters = true;
+      aoc::perf::enable();
+    }
+    else if (const aoc::problem *problem = find_problem(arg))
+      opts.problems.push_back(problem);
+    else
+      throw "Unknown problem '" + std::string(arg) + "'";
+  }
+
+  if (opts.problems.empty())
+    opts.problems = aoc::problems();
+
+  if (!opts.batch.empty())
+  {
+    if (opts.problems.size() != 1 || !opts.input.empty())
+      throw std::string("A batch needs a single problem, and no input file");
+    // the medians compared are per problem, a batch has one per input
+    if (!opts.compare.empty())
+      throw std::string("A batch can't be compared with previous results");
+    // the events of the worker processes stay in them
+    if (opts.sharded && !opts.trace.empty())
+      throw std::string("Worker processes can't be traced, run the batch in threads");
+
+    // as many inputs at once as the pool has threads
+    if (!jobs_set)
+      opts.jobs = 0;
+  }
+  else if (opts.sharded)
+    throw std::string("Worker processes need a batch");
+
+  // a sweep only reports the growth of each problem
+  if (opts.sweep && (!opts.trace.empty() || !opts.results.empty() || !opts.compare.empty()))
+    throw std::string("A sweep can't be traced (-T), written (-r, -o) or compared (--compare)");
+
+  // it runs until stopped: the trace would only grow, and never be written
+  if (!opts.serve.empty() && !opts.trace.empty())
+    throw std::string("The server can't be traced");
+
+  if (!opts.input.empty())
+  {
+    if (opts.problems.size() != 1)
+      throw std::string("An input file needs a single problem");
+    // a sweep generates its inputs, the server receives them
+    if (opts.sweep || !opts.serve.empty())
+      throw std::string("An input file can't be swept or served");
+    if (opts.input == "-")
+    {
+      opts.input = save_stdin();
+      opts.input_copied = true;
+    }
+  }
+
+  if (opts.bench && !warmup_set)
+    opts.warmup = default_warmup;
+
+  // the peak usage of every size is needed, and a single run is too noisy on small inputs
+  if (opts.sweep)
+  {
+    opts.memory = true;
+    opts.warmup = std::max(opts.warmup, 1u);
+    if (!opts.bench)
+      opts.repetitions = default_sweep_runs;
+  }
+
+  return opts;
+}
+
+int main(int ac, char **av)
+{
+  options opts;
+
+  try
+  {
+    opts = parse_options(ac, av);
   }
   catch (std::string &err)
   {
@@ -105,5 +1286,79 @@ int main()
     return 1;
   }
 
-  return 0;
+  const temp_path input_copy(opts.input_copied ? opts.input : std::filesystem::path());
+
+  if (aoc::trace::enabled())
+    aoc::trace::name_thread("main");
+
+  if (!opts.serve.empty())
+  {
+    try
+    {
+      std::cout << "Serving " << aoc::problems().size() << " problems on " << opts.serve.string() << std::endl;
+      aoc::serve::listen(opts.serve, [&opts](std::string_view name, const std::filesystem::path &input)
+      {
+        return serve_request(name, input, opts);
+      });
+    }
+    catch (std::string &err)
+    {
+      std::cerr << "Error: " << err << std::endl;
+      return 1;
+    }
+  }
+
+  if (opts.sweep || !opts.batch.empty())
+  {
+    try
+    {
+      return ((opts.sweep ? sweep_all(opts) : run_batch(opts)) > 0) ? 1 : 0;
+    }
+    catch (std::string &err)
+    {
+      std::cerr << "Error: " << err << std::endl;
+      return 1;
+    }
+  }
+
+  aoc::timer timer;
+  std::vector<result> results = run_all(opts);
+  const double micros = timer.GetTime<double, std::micro>();
+
+  const bool boxes = (opts.results != "-");
+
+  int status = 0;
+  for (result &res : results)
+  {
+    if (!res.error.empty())
+    {
+      std::cerr << res.problem->name << ": Error: " << res.error << std::endl;
+      status = 1;
+      continue;
+    }
+    if (boxes)
+      display_result(res, opts);
+  }
+
+  if (boxes && results.size() > 1)
+    display_summary(results, micros);
+
+  try
+  {
+    if (!opts.results.empty())
+      write_results(results, opts);
+
+    if (!opts.trace.empty())
+      aoc::trace::write(opts.trace);
+
+    if (!opts.compare.empty() && display_comparison(results, opts) > 0)
+      status = 1;
+  }
+  catch (std::string &err)
+  {
+    std::cerr << "Error: " << err << std::endl;
+    status = 1;
+  }
+
+  return status;
 }
@@ -0,0 +1,227 @@
+#include "AdventOfCode.hpp"
+
+#include "exec.hpp"
+#include "memory.hpp"
+#include "trace.hpp"
+
+namespace aoc::exec
+{
+  namespace
+  {
+    // the pool and worker index of the current thread, if it is a pool worker
+    thread_local pool  *current_pool = nullptr;
+    thread_local size_t current_worker = 0;
+
+    std::atomic<unsigned> thread_count = 0; // 0: not set yet
+    std::unique_ptr<pool> default_pool;
+    std::mutex            default_pool_mutex;
+
+    unsigned hardware_threads()
+    {
+      return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The pool shared by every algorithm, with one worker less than `threads()`: the caller is the last one
+    pool *get_pool()
+    {
+      std::lock_guard lock(default_pool_mutex);
+
+      if (!default_pool && threads() > 1)
+        default_pool = std::make_unique<pool>(threads() - 1);
+      return default_pool.get();
+    }
+  }
+
+  pool::pool(unsigned workers)
+  {
+    m_workers.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i)
+      m_workers.emplace_back(std::make_unique<worker>());
+
+    // every deque must exist before a worker tries to steal from it
+    for (size_t i = 0; i < m_workers.size(); ++i)
+      m_workers[i]->thread = std::thread(&pool::run, this, i);
+  }
+
+  pool::~pool()
+  {
+    {
+      std::lock_guard lock(m_mutex);
+      m_stop = true;
+    }
+    m_wakeup.notify_all();
+
+    for (std::unique_ptr<worker> &w : m_workers)
+      w->thread.join();
+  }
+
+  void pool::submit(task t)
+  {
+    // a worker keeps the tasks it spawns, the others will steal them if they are idle
+    const size_t index = (current_pool == this) ? current_worker : (m_next++ % m_workers.size());
+
+    {
+      worker &w = *m_workers[index];
+      std::lock_guard lock(w.mutex);
+      w.tasks.push_back(std::move(t));
+    }
+    trace::instant("submit", "exec");
+
+    ++m_pending;
+    {
+      std::lock_guard lock(m_mutex);
+    }
+    m_wakeup.notify_one();
+  }
+
+  bool pool::pop(size_t index, task &t)
+  {
+    // newest task of our own deque
+    {
+      worker &w = *m_workers[index];
+      std::lock_guard lock(w.mutex);
+      if (!w.tasks.empty())
+      {
+        t = std::move(w.tasks.back());
+        w.tasks.pop_back();
+        return true;
+      }
+    }
+
+    // oldest task of the others
+    for (size_t i = 1; i < m_workers.size(); ++i)
+    {
+      worker &w = *m_workers[(index + i) % m_workers.size()];
+      std::lock_guard lock(w.mutex);
+      if (!w.tasks.empty())
+      {
+        t = std::move(w.tasks.front());
+        w.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void pool::run(size_t index)
+  {
+    current_pool = this;
+    current_worker = index;
+
+    if (trace::enabled())
+      trace::name_thread("worker " + std::to_string(index + 1));
+
+    task t;
+    while (true)
+    {
+      if (pop(index, t))
+      {
+        --m_pending;
+        t();
+        t = nullptr;
+        continue;
+      }
+
+      std::unique_lock lock(m_mutex);
+      m_wakeup.wait(lock, [this]() { return m_pending > 0 || m_stop; });
+      if (m_stop && m_pending <= 0)
+        return;
+    }
+  }
+
+  unsigned threads()
+  {
+#ifdef SINGLE_THREADED
+    return 1;
+#else
+    if (thread_count == 0)
+      thread_count = hardware_threads();
+    return thread_count;
+#endif
+  }
+
+  void set_threads(unsigned count)
+  {
+    std::lock_guard lock(default_pool_mutex);
+
+    thread_count = count ? count : hardware_threads();
+    default_pool.reset(); // rebuilt with the new size on next use
+  }
+
+  void after_fork()
+  {
+    new (&default_pool_mutex) std::mutex();
+    (void)default_pool.release(); // leaked on purpose: its destructor would wait for threads that are not there
+    current_pool = nullptr;
+  }
+
+  void detail::run_chunks(size_t count, const std::function<void(size_t)> &fn, unsigned max_threads)
+  {
+    if (count == 0)
+      return;
+
+    unsigned helpers = std::min<size_t>(threads(), count) - 1;
+    if (max_threads)
+      helpers = std::min(helpers, max_threads - 1);
+
+    pool *workers = helpers ? get_pool() : nullptr;
+    if (!workers)
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        trace::span chunk("chunk", "exec", int64_t(i));
+        fn(i);
+      }
+      return;
+    }
+
+    // shared with the helpers: one may only start after every chunk is done and this function returned
+    struct state
+    {
+      std::atomic<size_t>     next = 0;
+      std::atomic<size_t>     done = 0;
+      std::mutex              mutex;
+      std::condition_variable finished;
+      std::exception_ptr      error;
+    };
+    const std::shared_ptr<state> st = std::make_shared<state>();
+
+    // `fn` is only used after claiming a chunk, and it outlives every chunk.
+    // The allocations of the chunks are counted by the caller's tracker, whichever thread runs them
+    const auto work = [st, &fn, count, tracker = memory::current()]()
+    {
+      memory::scope tracking(tracker);
+
+      for (size_t i; (i = st->next++) < count;)
+      {
+        try
+        {
+          trace::span chunk("chunk", "exec", int64_t(i));
+          fn(i);
+        }
+        catch (...)
+        {
+          std::lock_guard lock(st->mutex);
+          if (!st->error)
+            st->error = std::current_exception();
+        }
+
+        if (++st->done == count)
+        {
+          std::lock_guard lock(st->mutex);
+          st->finished.notify_all();
+        }
+      }
+    };
+
+    for (unsigned i = 0; i < helpers; ++i)
+      workers->submit(work);
+    work();
+
+    std::unique_lock lock(st->mutex);
+    st->finished.wait(lock, [&st, count]() { return st->done == count; });
+
+    if (st->error)
+      std::rethrow_exception(st->error);
+  }
+}
@@ -0,0 +1,583 @@
+#include "AdventOfCode.hpp"
+
+#include "generate.hpp"
+
+namespace aoc::generate
+{
+  namespace
+  {
+    // xoshiro256** seeded through splitmix64: unlike the standard distributions,
+    // the same seed gives the same numbers with every compiler and standard library
+    class prng
+    {
+    public:
+      explicit prng(uint64_t seed)
+      {
+        for (uint64_t &s : m_state)
+        {
+          seed += 0x9E3779B97F4A7C15;
+          uint64_t z = seed;
+          z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+          z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+          s = z ^ (z >> 31);
+        }
+      }
+
+      uint64_t next()
+      {
+        const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+      }
+
+      // in [0, n)
+      uint64_t below(uint64_t n) { return next() % n; }
+
+      // in [min, max]
+      int64_t between(int64_t min, int64_t max) { return min + int64_t(below(uint64_t(max - min) + 1)); }
+
+      // true with a probability of `percent` / 100
+      bool chance(unsigned percent) { return below(100) < percent; }
+
+      template<class T>
+      const T &pick(const std::vector<T> &values) { return values[below(values.size())]; }
+
+      template<class T>
+      void shuffle(std::vector<T> &values)
+      {
+        for (size_t i = values.size(); i > 1; --i)
+          std::swap(values[i - 1], values[below(i)]);
+      }
+
+    private:
+      static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+      uint64_t m_state[4];
+    };
+
+    // Buffered output, the inputs can be hundreds of megabytes
+    class writer
+    {
+    public:
+      explicit writer(std::ostream &out) : m_out(out) { m_buffer.reserve(capacity + 64); }
+      ~writer() { flush(); }
+
+      writer &operator<<(char c)
+      {
+        m_buffer += c;
+        return check();
+      }
+
+      writer &operator<<(std::string_view str)
+      {
+        m_buffer += str;
+        return check();
+      }
+
+      template<class T>
+        requires std::is_integral_v<T>
+      writer &operator<<(T value)
+      {
+        char digits[24];
+        const std::to_chars_result res = std::to_chars(digits, digits + sizeof(digits), value);
+        m_buffer.append(digits, res.ptr);
+        return check();
+      }
+
+      void flush()
+      {
+        m_out.write(m_buffer.data(), std::streamsize(m_buffer.size()));
+        m_buffer.clear();
+      }
+
+    private:
+      writer &check()
+      {
+        if (m_buffer.size() >= capacity)
+          flush();
+        return *this;
+      }
+
+    private:
+      static constexpr size_t capacity = 1 << 20;
+
+      std::ostream &m_out;
+      std::string   m_buffer;
+    };
+
+    // Location IDs in two columns, some of the right ones repeating left ones
+    void day01(writer &out, size_t pairs, prng &rng)
+    {
+      std::vector<int64_t> recent(64, 0);
+
+      for (size_t i = 0; i < pairs; ++i)
+      {
+        const int64_t a = rng.between(10000, 99999);
+        recent[i % recent.size()] = a;
+
+        const int64_t b = (i > recent.size() && rng.chance(30)) ? rng.pick(recent) : rng.between(10000, 99999);
+        out << a << "   " << b << '\n';
+      }
+    }
+
+    // Reports of 5 to 8 levels, half of them safe
+    void day02(writer &out, size_t reports, prng &rng)
+    {
+      for (size_t i = 0; i < reports; ++i)
+      {
+        const int64_t count = rng.between(5, 8);
+        const int64_t direction = rng.chance(50) ? 1 : -1;
+        const bool safe = rng.chance(50);
+
+        int64_t level = (direction > 0) ? rng.between(1, 60) : rng.between(40, 99);
+        for (int64_t j = 0; j < count; ++j)
+        {
+          if (j > 0)
+            out << ' ';
+          out << level;
+
+          int64_t step = direction * rng.between(1, 3);
+          if (!safe && rng.chance(25))
+            step = rng.chance(50) ? 0 : -direction * rng.between(1, 5);
+          level = std::clamp<int64_t>(level + step, 1, 99);
+        }
+        out << '\n';
+      }
+    }
+
+    // Corrupted memory: valid and broken instructions in noise, on lines of about 3000 characters
+    void day03(writer &out, size_t instructions, prng &rng)
+    {
+      static const std::vector<std::string_view> noise = {
+        "who()", "what()", "where()", "when()", "why()", "how()", "select()", "from()",
+        "'", "[", "]", "{", "}", "<", ">", "(", ")", "!", "?", "@", "#", "$", "%", "^", "&", "*", "-", "+", "~", ":", ";", ",", " ", "/"
+      };
+
+      size_t line = 0;
+      for (size_t i = 0; i < instructions; ++i)
+      {
+        const uint64_t kind = rng.below(100);
+
+        if (kind < 70)
+          out << "mul(" << rng.between(1, 999) << ',' << rng.between(1, 999) << ')';
+        else if (kind < 77)
+          out << "do()";
+        else if (kind < 84)
+          out << "don't()";
+        else if (kind < 92)
+          out << "mul[" << rng.between(1, 999) << ',' << rng.between(1, 999) << ']';
+        else
+          out << rng.pick(noise) << '(' << rng.between(1, 999) << ',' << rng.between(1, 999) << ')';
+
+        for (int64_t n = rng.between(0, 3); n > 0; --n)
+          out << rng.pick(noise);
+
+        if (++line == 200)
+        {
+          out << '\n';
+          line = 0;
+        }
+      }
+      if (line)
+        out << '\n';
+    }
+
+    // Square grid of the 4 letters of XMAS
+    void day04(writer &out, size_t side, prng &rng)
+    {
+      constexpr char letters[] = "XMAS";
+
+      std::string row(side, ' ');
+      for (size_t y = 0; y < side; ++y)
+      {
+        for (char &c : row)
+          c = letters[rng.below(4)];
+        out << row << '\n';
+      }
+    }
+
+    // Ordering rules for every pair of 49 pages, then updates of 5 to 23 pages, half of them in order.
+    // The rules follow a single order of the pages, no update holds a cycle
+    void day05(writer &out, size_t updates, prng &rng)
+    {
+      std::vector<int64_t> pages;
+      for (int64_t page = 10; page < 100; ++page)
+        pages.push_back(page);
+      rng.shuffle(pages);
+      pages.resize(49);
+
+      // pages[i] goes before pages[j] for every i < j
+      std::vector<std::pair<size_t, size_t>> rules;
+      for (size_t i = 0; i < pages.size(); ++i)
+        for (size_t j = i + 1; j < pages.size(); ++j)
+          rules.emplace_back(i, j);
+      rng.shuffle(rules);
+
+      for (const auto &[before, after] : rules)
+        out << pages[before] << '|' << pages[after] << '\n';
+      out << '\n';
+
+      std::vector<size_t> update;
+      std::vector<size_t> indices(pages.size());
+      for (size_t i = 0; i < indices.size(); ++i)
+        indices[i] = i;
+
+      for (size_t i = 0; i < updates; ++i)
+      {
+        rng.shuffle(indices);
+        update.assign(indices.begin(), indices.begin() + rng.between(2, 11) * 2 + 1);
+
+        if (rng.chance(50))
+          std::sort(update.begin(), update.end());
+
+        for (size_t j = 0; j < update.size(); ++j)
+          out << (j ? "," : "") << pages[update[j]];
+        out << '\n';
+      }
+    }
+
+    // A guard route about 8 times as long as the side, then obstacles on 5% of the other cells of a square grid.
+    // The route is drawn first with an obstacle in front of each turn: on a plain random grid the guards that
+    // leave it walk straight to the nearest edge, a few dozen cells whatever the side
+    void day06(writer &out, size_t side, prng &rng)
+    {
+      const size_t size = side * side;
+      const size_t target = std::min(side * 8, size / 4);
+      const uint64_t longest = std::max<size_t>(side / 8, 1); // longest straight line of the route
+
+      constexpr int64_t dx[] = { 0, 1, 0, -1 };
+      constexpr int64_t dy[] = { -1, 0, 1, 0 };
+
+      std::vector<char> grid(size);
+      std::vector<uint8_t> visited(size); // directions the route goes through each cell in
+
+      const auto inside = [side](int64_t x, int64_t y) { return x >= 0 && y >= 0 && x < int64_t(side) && y < int64_t(side); };
+      const auto at = [side](int64_t x, int64_t y) { return size_t(y) * side + size_t(x); };
+
+      // Whether the guard can walk the cells ahead of it up to the edge: none is an obstacle or walked that way already
+      const auto leaves = [&](int64_t x, int64_t y, int dir)
+      {
+        for (x += dx[dir], y += dy[dir]; inside(x, y); x += dx[dir], y += dy[dir])
+          if (grid[at(x, y)] == '#' || (visited[at(x, y)] & (1 << dir)))
+            return false;
+        return true;
+      };
+
+      // Whether the guard can walk `length` cells ahead then turn right: the cells it walks are no obstacle and none
+      // is walked that way already (it would walk in circles), the obstacle it turns at is on none of the route
+      const auto turns = [&](int64_t x, int64_t y, int dir, uint64_t length)
+      {
+        for (uint64_t i = 0; i < length; ++i)
+        {
+          x += dx[dir];
+          y += dy[dir];
+          if (!inside(x, y) || grid[at(x, y)] == '#' || (visited[at(x, y)] & (1 << dir)))
+            return false;
+        }
+        // nor does it turn onto a stretch walked that way already, or towards the edge it is next to
+        const int turned = (dir + 1) % 4;
+        const int64_t nx = x + dx[turned];
+        const int64_t ny = y + dy[turned];
+        if ((visited[at(x, y)] & (1 << turned)) || !inside(nx, ny) || (visited[at(nx, ny)] & (1 << turned)))
+          return false;
+
+        const int64_t ox = x + dx[dir];
+        const int64_t oy = y + dy[dir];
+        return inside(ox, oy) && (grid[at(ox, oy)] == '#' || !visited[at(ox, oy)]);
+      };
+
+      for (int restart = 0;; ++restart)
+      {
+        std::fill(grid.begin(), grid.end(), '.');
+        std::fill(visited.begin(), visited.end(), 0);
+
+        const size_t start = rng.below(size);
+        int64_t x = int64_t(start % side);
+        int64_t y = int64_t(start / side);
+        int dir = 0;
+
+        // turns until the route is long enough and the way to the edge is free, or until no turn fits
+        size_t walked = 0;
+        bool stuck = false;
+        while (true)
+        {
+          visited[at(x, y)] |= uint8_t(1 << dir);
+          if (walked >= target && leaves(x, y, dir))
+            break;
+
+          // every length from a random one, 0 turning where it stands against an obstacle already there or a new one.
+          // Longer ones only when none fits, along a stretch of the route walked the other way
+          const uint64_t first = rng.below(longest + 1);
+          uint64_t length = 0;
+          bool found = false;
+          for (uint64_t i = 0; i <= longest && !found; ++i)
+          {
+            length = (first + i) % (longest + 1);
+            found = turns(x, y, dir, length);
+          }
+          for (uint64_t longer = longest + 1; longer < side && !found; ++longer)
+          {
+            found = turns(x, y, dir, longer);
+            if (found)
+              length = longer;
+          }
+          if (!found)
+          {
+            stuck = true;
+            break;
+          }
+
+          for (uint64_t i = 0; i < length; ++i)
+          {
+            x += dx[dir];
+            y += dy[dir];
+            visited[at(x, y)] |= uint8_t(1 << dir);
+          }
+          grid[at(x + dx[dir], y + dy[dir])] = '#';
+          dir = (dir + 1) % 4;
+          walked += length;
+        }
+
+        // a shorter route still does once many failed, on grids too small for the one wanted
+        if (stuck && (restart < 64 || !leaves(x, y, dir)))
+          continue;
+
+        for (; inside(x, y); x += dx[dir], y += dy[dir])
+          visited[at(x, y)] |= uint8_t(1 << dir);
+        grid[start] = '^';
+        break;
+      }
+
+      // only off the route: the guard never meets them
+      for (size_t i = 0; i < size; ++i)
+        if (!visited[i] && rng.chance(5))
+          grid[i] = '#';
+
+      for (size_t y = 0; y < side; ++y)
+        out << std::string_view(&grid[y * side], side) << '\n';
+    }
+
+    // Equations of 2 to 11 operands, 60% of them solvable with +, * and ||
+    void day07(writer &out, size_t equations, prng &rng)
+    {
+      std::vector<uint64_t> operands;
+
+      for (size_t i = 0; i < equations; ++i)
+      {
+        operands.resize(size_t(rng.between(2, 11)));
+        for (uint64_t &operand : operands)
+          operand = uint64_t(rng.chance(40) ? rng.between(1, 9) : rng.between(10, 999));
+
+        uint64_t target = operands[0];
+        for (size_t j = 1; j < operands.size(); ++j)
+        {
+          const uint64_t b = operands[j];
+
+          uint64_t shift = 10;
+          while (shift <= b)
+            shift *= 10;
+
+          // an operator overflowing the target falls back to an addition
+          const uint64_t op = rng.below(3);
+          if (op == 1 && target <= UINT64_MAX / 1000 / b)
+            target *= b;
+          else if (op == 2 && target <= UINT64_MAX / 1000 / shift)
+            target = target * shift + b;
+          else
+            target += b;
+        }
+
+        if (rng.chance(40))
+          target += uint64_t(rng.between(1, 99));
+
+        out << target << ':';
+        for (uint64_t operand : operands)
+          out << ' ' << operand;
+        out << '\n';
+      }
+    }
+
+    // Antennas of 62 frequencies on 8% of a square grid
+    void day08(writer &out, size_t side, prng &rng)
+    {
+      constexpr std::string_view frequencies = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+      std::string row(side, '.');
+      for (size_t y = 0; y < side; ++y)
+      {
+        for (char &c : row)
+          c = rng.chance(8) ? frequencies[rng.below(frequencies.size())] : '.';
+        out << row << '\n';
+      }
+    }
+
+    // Disk map: files of 1 to 9 blocks separated by 0 to 9 free blocks, starting and ending with a file
+    void day09(writer &out, size_t digits, prng &rng)
+    {
+      digits |= 1;
+
+      for (size_t i = 0; i < digits; ++i)
+        out << char('0' + ((i % 2 == 0) ? rng.between(1, 9) : rng.between(0, 9)));
+      out << '\n';
+    }
+
+    // Heights 0 to 9 on a square grid, mostly rising diagonally so trails are long
+    void day10(writer &out, size_t side, prng &rng)
+    {
+      std::string row(side, '0');
+      for (size_t y = 0; y < side; ++y)
+      {
+        for (size_t x = 0; x < side; ++x)
+        {
+          const uint64_t base = ((x / 10) * 7 + (y / 10) * 3) % 10;
+          row[x] = char('0' + (rng.chance(85) ? (base + x + y) % 10 : rng.below(10)));
+        }
+        out << row << '\n';
+      }
+    }
+
+    // A line of stones engraved with numbers of 1 to 7 digits
+    void day11(writer &out, size_t stones, prng &rng)
+    {
+      for (size_t i = 0; i < stones; ++i)
+      {
+        if (i > 0)
+          out << ' ';
+
+        const int64_t digits = rng.between(1, 7);
+        int64_t max = 1;
+        for (int64_t d = 0; d < digits; ++d)
+          max *= 10;
+        out << rng.between(max / 10 - (digits == 1), max - 1);
+      }
+      out << '\n';
+    }
+
+    // Garden plots of 26 plants on a square grid, each plot usually copies a neighbour to form regions
+    void day12(writer &out, size_t side, prng &rng)
+    {
+      std::string previous(side, 'A');
+      std::string row(side, 'A');
+
+      for (size_t y = 0; y < side; ++y)
+      {
+        for (size_t x = 0; x < side; ++x)
+        {
+          const uint64_t roll = rng.below(100);
+
+          if (roll < 45 && x > 0)
+            row[x] = row[x - 1];
+          else if (roll < 90 && y > 0)
+            row[x] = previous[x];
+          else
+            row[x] = char('A' + rng.below(26));
+        }
+        out << row << '\n';
+        std::swap(row, previous);
+      }
+    }
+
+    // Claw machines with independent buttons, 60% of the prizes reachable
+    void day13(writer &out, size_t machines, prng &rng)
+    {
+      for (size_t i = 0; i < machines; ++i)
+      {
+        int64_t ax, ay, bx, by;
+        do
+        {
+          ax = rng.between(10, 99);
+          ay = rng.between(10, 99);
+          bx = rng.between(10, 99);
+          by = rng.between(10, 99);
+        } while (ax * by == ay * bx); // Cramer's rule needs a non zero determinant
+
+        int64_t px, py;
+        if (rng.chance(60))
+        {
+          const int64_t a = rng.between(0, 100);
+          const int64_t b = rng.between(0, 100);
+          px = a * ax + b * bx;
+          py = a * ay + b * by;
+        }
+        else
+        {
+          px = rng.between(1000, 20000);
+          py = rng.between(1000, 20000);
+        }
+
+        if (i > 0)
+          out << '\n';
+        out << "Button A: X+" << ax << ", Y+" << ay << '\n';
+        out << "Button B: X+" << bx << ", Y+" << by << '\n';
+        out << "Prize: X=" << px << ", Y=" << py << '\n';
+      }
+    }
+
+    // Drones on the 101x103 room, moving up to 100 tiles per second on each axis
+    void day14(writer &out, size_t drones, prng &rng)
+    {
+      for (size_t i = 0; i < drones; ++i)
+      {
+        out << "p=" << rng.between(0, 100) << ',' << rng.between(0, 102)
+            << " v=" << rng.between(-100, 100) << ',' << rng.between(-100, 100) << '\n';
+      }
+    }
+
+    // Binds a day's generator to the public signature
+    template<void (*Day)(writer &, size_t, prng &)>
+    void write_day(std::ostream &out, size_t size, uint64_t seed)
+    {
+      prng rng(seed);
+      writer w(out);
+      Day(w, size, rng);
+    }
+  }
+
+  const std::vector<generator> &generators()
+  {
+    static const std::vector<generator> all = {
+      { "Day 01", "location pairs", 10'000'000,  1'000, false, write_day<day01> },
+      { "Day 02", "reports",         1'000'000,  1'000, false, write_day<day02> },
+      { "Day 03", "instructions",    1'000'000,    700, false, write_day<day03> },
+      { "Day 04", "grid side",           5'000,    140, true,  write_day<day04> },
+      { "Day 05", "updates",           100'000,    200, false, write_day<day05> },
+      { "Day 06", "grid side",           5'000,    130, true,  write_day<day06> },
+      { "Day 07", "equations",       1'000'000,    850, false, write_day<day07> },
+      { "Day 08", "grid side",           1'000,     50, true,  write_day<day08> },
+      { "Day 09", "digits",         10'000'000, 20'000, false, write_day<day09> },
+      { "Day 10", "grid side",           5'000,     45, true,  write_day<day10> },
+      { "Day 11", "stones",              1'000,      8, false, write_day<day11> },
+      { "Day 12", "grid side",           5'000,    140, true,  write_day<day12> },
+      { "Day 13", "machines",        1'000'000,    320, false, write_day<day13> },
+      { "Day 14", "drones",          1'000'000,    500, false, write_day<day14> },
+    };
+    return all;
+  }
+
+  const generator *find(std::string_view name)
+  {
+    unsigned number = 0;
+    const char *end = name.data() + name.size();
+    const bool numeric = (std::from_chars(name.data(), end, number).ptr == end);
+
+    for (const generator &gen : generators())
+    {
+      if (gen.name == name || (numeric && unsigned(std::atoi(gen.name + 4)) == number))
+        return &gen;
+    }
+    return nullptr;
+  }
+
+  void write(const generator &gen, std::ostream &out, size_t size, uint64_t seed)
+  {
+    // each problem has its own sequence, whichever problems are generated along with it
+    gen.write(out, size, seed ^ (uint64_t(std::atoi(gen.name + 4)) << 32));
+  }
+}
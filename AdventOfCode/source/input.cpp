@@ -0,0 +1,153 @@
+#include "AdventOfCode.hpp"
+
+#include "input.hpp"
+
+#ifdef WINDOWS
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+namespace aoc
+{
+#ifdef WINDOWS
+  input::input(const std::filesystem::path &path)
+  {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+      const DWORD err = GetLastError();
+      if (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND)
+        throw "Input file " + path.string() + " does not exist";
+      throw "Can't open input file '" + path.string() + "': error " + std::to_string(err);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+      CloseHandle(file);
+      throw "Can't read input file '" + path.string() + "': error " + std::to_string(GetLastError());
+    }
+    m_size = size_t(size.QuadPart);
+
+    // empty files can't be mapped
+    if (m_size > 0)
+    {
+      HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mapping)
+      {
+        m_data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping); // the view keeps the mapping alive
+      }
+    }
+    CloseHandle(file);
+
+    if (m_size > 0 && !m_data)
+      throw "Can't map input file '" + path.string() + "': error " + std::to_string(GetLastError());
+
+    measure();
+  }
+
+  void input::release()
+  {
+    if (m_data)
+      UnmapViewOfFile(m_data);
+  }
+#else
+  input::input(const std::filesystem::path &path)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+      if (errno == ENOENT)
+        throw "Input file " + path.string() + " does not exist";
+      throw "Can't open input file '" + path.string() + "': " + strerror(errno);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+    {
+      const int err = errno;
+      ::close(fd);
+      throw "Can't read input file '" + path.string() + "': " + strerror(err);
+    }
+    m_size = size_t(st.st_size);
+
+    // empty files can't be mapped
+    if (m_size > 0)
+    {
+      void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED)
+      {
+        const int err = errno;
+        ::close(fd);
+        throw "Can't map input file '" + path.string() + "': " + strerror(err);
+      }
+
+      // inputs are small and always entirely read, fault them in ahead of time
+      madvise(data, m_size, MADV_WILLNEED);
+      m_data = static_cast<const char *>(data);
+    }
+    ::close(fd); // the mapping stays valid
+
+    measure();
+  }
+
+  void input::release()
+  {
+    if (m_data)
+      munmap(const_cast<char *>(m_data), m_size);
+  }
+#endif
+
+  input::~input()
+  {
+    release();
+  }
+
+  input::input(input &&other) noexcept
+  {
+    *this = std::move(other);
+  }
+
+  input &input::operator=(input &&other) noexcept
+  {
+    if (this != &other)
+    {
+      release();
+      m_data   = std::exchange(other.m_data, nullptr);
+      m_size   = std::exchange(other.m_size, 0);
+      m_width  = std::exchange(other.m_width, 0);
+      m_height = std::exchange(other.m_height, 0);
+      m_stride = std::exchange(other.m_stride, 0);
+    }
+    return *this;
+  }
+
+  void input::measure()
+  {
+    m_width = m_height = m_stride = 0;
+    if (m_size == 0)
+      return;
+
+    const char *end = m_data + m_size;
+    const char *eol = static_cast<const char *>(std::memchr(m_data, '\n', m_size));
+
+    m_stride = eol ? size_t(eol - m_data) + 1 : m_size;
+    m_width = eol ? size_t(eol - m_data) : m_size;
+    if (m_width > 0 && m_data[m_width - 1] == '\r')
+      --m_width;
+
+    // count the lines, the last one may not be terminated
+    for (const char *p = m_data; (p = static_cast<const char *>(std::memchr(p, '\n', end - p))); ++p)
+      ++m_height;
+    m_height += (m_data[m_size - 1] != '\n');
+  }
+}
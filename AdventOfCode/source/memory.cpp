@@ -0,0 +1,221 @@
+#include "AdventOfCode.hpp"
+
+#include "memory.hpp"
+
+#include <new>
+
+#ifdef WINDOWS
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <windows.h>
+# include <psapi.h>
+#else
+# include <sys/resource.h>
+#endif
+
+namespace aoc::memory
+{
+  namespace
+  {
+    constinit thread_local tracker *current_tracker = nullptr;
+
+    void store_max(std::atomic<int64_t> &target, int64_t value) noexcept
+    {
+      int64_t previous = target.load(std::memory_order_relaxed);
+      while (previous < value && !target.compare_exchange_weak(previous, value, std::memory_order_relaxed))
+        ;
+    }
+  }
+
+  void tracker::on_allocate(size_t size) noexcept
+  {
+    m_allocations.fetch_add(1, std::memory_order_relaxed);
+    m_bytes.fetch_add(size, std::memory_order_relaxed);
+    store_max(m_peak, m_live.fetch_add(int64_t(size), std::memory_order_relaxed) + int64_t(size));
+  }
+
+  tracker::mark tracker::begin() noexcept
+  {
+    mark start;
+    start.allocations = m_allocations.load(std::memory_order_relaxed);
+    start.bytes = m_bytes.load(std::memory_order_relaxed);
+    start.live = m_live.load(std::memory_order_relaxed);
+
+    // the peak of this measure starts from the current live bytes
+    start.peak = m_peak.exchange(start.live, std::memory_order_relaxed);
+    return start;
+  }
+
+  usage tracker::end(const mark &start) noexcept
+  {
+    const int64_t peak = m_peak.load(std::memory_order_relaxed);
+
+    usage result;
+    result.allocations = m_allocations.load(std::memory_order_relaxed) - start.allocations;
+    result.bytes = m_bytes.load(std::memory_order_relaxed) - start.bytes;
+    result.peak = size_t(std::max<int64_t>(peak - start.live, 0));
+
+    // the enclosing measure peaked at the highest of both
+    store_max(m_peak, start.peak);
+    return result;
+  }
+
+  tracker *current() noexcept
+  {
+    return current_tracker;
+  }
+
+  scope::scope(tracker *t) noexcept : m_previous(current_tracker)
+  {
+    current_tracker = t;
+  }
+
+  scope::~scope()
+  {
+    current_tracker = m_previous;
+  }
+
+  bool counts_allocations()
+  {
+#ifdef NO_MEMORY_HOOK
+    return false;
+#else
+    return true;
+#endif
+  }
+
+  size_t peak_rss()
+  {
+#if defined(WINDOWS)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+      return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+# ifdef MACOSX
+    return size_t(usage.ru_maxrss);        // bytes
+# else
+    return size_t(usage.ru_maxrss) * 1024; // kilobytes
+# endif
+#endif
+  }
+}
+
+#ifndef NO_MEMORY_HOOK
+namespace
+{
+  using aoc::memory::tracker;
+  using aoc::memory::current_tracker;
+
+  // The size of a block is stored right before it, the header keeps the block aligned
+  constexpr size_t header_size = alignof(std::max_align_t);
+
+  void *allocate(size_t size, size_t alignment) noexcept
+  {
+    const size_t offset = std::max(alignment, header_size);
+
+    void *raw;
+    if (alignment <= alignof(std::max_align_t))
+      raw = std::malloc(offset + size);
+    else
+    {
+#ifdef WINDOWS
+      raw = _aligned_malloc(offset + size, alignment);
+#else
+      raw = std::aligned_alloc(alignment, (offset + size + alignment - 1) & ~(alignment - 1));
+#endif
+    }
+
+    if (!raw)
+      return nullptr;
+
+    std::byte *block = static_cast<std::byte *>(raw) + offset;
+    std::memcpy(block - sizeof(size_t), &size, sizeof(size_t));
+
+    if (tracker *t = current_tracker)
+      t->on_allocate(size);
+    return block;
+  }
+
+  void deallocate(void *ptr, size_t alignment) noexcept
+  {
+    if (!ptr)
+      return;
+
+    std::byte *block = static_cast<std::byte *>(ptr);
+
+    size_t size;
+    std::memcpy(&size, block - sizeof(size_t), sizeof(size_t));
+
+    if (tracker *t = current_tracker)
+      t->on_deallocate(size);
+
+    void *raw = block - std::max(alignment, header_size);
+    if (alignment <= alignof(std::max_align_t))
+      std::free(raw);
+    else
+    {
+#ifdef WINDOWS
+      _aligned_free(raw);
+#else
+      std::free(raw);
+#endif
+    }
+  }
+
+  void *allocate_or_throw(size_t size, size_t alignment)
+  {
+    while (true)
+    {
+      if (void *ptr = allocate(size, alignment))
+        return ptr;
+
+      const std::new_handler handler = std::get_new_handler();
+      if (!handler)
+        throw std::bad_alloc();
+      handler();
+    }
+  }
+
+  void *allocate_or_null(size_t size, size_t alignment) noexcept
+  {
+    try
+    {
+      return allocate_or_throw(size, alignment);
+    }
+    catch (...)
+    {
+      return nullptr;
+    }
+  }
+
+  constexpr size_t default_alignment = alignof(std::max_align_t);
+}
+
+void *operator new(size_t size) { return allocate_or_throw(size, default_alignment); }
+void *operator new[](size_t size) { return allocate_or_throw(size, default_alignment); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return allocate_or_null(size, default_alignment); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return allocate_or_null(size, default_alignment); }
+
+void *operator new(size_t size, std::align_val_t al) { return allocate_or_throw(size, size_t(al)); }
+void *operator new[](size_t size, std::align_val_t al) { return allocate_or_throw(size, size_t(al)); }
+void *operator new(size_t size, std::align_val_t al, const std::nothrow_t &) noexcept { return allocate_or_null(size, size_t(al)); }
+void *operator new[](size_t size, std::align_val_t al, const std::nothrow_t &) noexcept { return allocate_or_null(size, size_t(al)); }
+
+void operator delete(void *ptr) noexcept { deallocate(ptr, default_alignment); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr, default_alignment); }
+void operator delete(void *ptr, size_t) noexcept { deallocate(ptr, default_alignment); }
+void operator delete[](void *ptr, size_t) noexcept { deallocate(ptr, default_alignment); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { deallocate(ptr, default_alignment); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { deallocate(ptr, default_alignment); }
+
+void operator delete(void *ptr, std::align_val_t al) noexcept { deallocate(ptr, size_t(al)); }
+void operator delete[](void *ptr, std::align_val_t al) noexcept { deallocate(ptr, size_t(al)); }
+void operator delete(void *ptr, size_t, std::align_val_t al) noexcept { deallocate(ptr, size_t(al)); }
+void operator delete[](void *ptr, size_t, std::align_val_t al) noexcept { deallocate(ptr, size_t(al)); }
+void operator delete(void *ptr, std::align_val_t al, const std::nothrow_t &) noexcept { deallocate(ptr, size_t(al)); }
+void operator delete[](void *ptr, std::align_val_t al, const std::nothrow_t &) noexcept { deallocate(ptr, size_t(al)); }
+#endif
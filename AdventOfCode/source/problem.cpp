@@ -0,0 +1,31 @@
+#include "AdventOfCode.hpp"
+
+namespace aoc
+{
+  static std::vector<const problem *> &registry()
+  {
+    static std::vector<const problem *> REGISTRY;
+
+    return REGISTRY;
+  }
+
+  problem::problem(const char *name, solver solve) : name(name), solve(solve)
+  {
+    std::vector<const problem *> &reg = registry();
+
+    // static initialization order is unspecified, keep the registry sorted
+    reg.insert(
+      std::upper_bound(
+        reg.begin(), reg.end(),
+        this,
+        [](const problem *a, const problem *b) { return a->name < b->name; }
+      ),
+      this
+    );
+  }
+
+  const std::vector<const problem *> &problems()
+  {
+    return registry();
+  }
+}
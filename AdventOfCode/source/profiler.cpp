@@ -0,0 +1,70 @@
+#include "AdventOfCode.hpp"
+
+namespace aoc
+{
+  thread_local profile profiler;
+
+  size_t profile::begin(const char *name)
+  {
+    const size_t parent = m_stack.empty() ? phase::npos : m_stack.back().index;
+
+    size_t index = 0;
+    while (index < m_phases.size() && (m_phases[index].parent != parent || m_phases[index].name != name))
+      ++index;
+
+    if (index == m_phases.size())
+    {
+      phase &p = m_phases.emplace_back();
+      p.name = name;
+      p.parent = parent;
+      p.depth = m_stack.size();
+    }
+
+    frame &f = m_stack.emplace_back(frame{ .index = index, .name = name });
+
+    // started last, the bookkeeping above is not counted
+    if (memory::tracker *tracker = memory::current())
+      f.start = tracker->begin();
+    if (perf::enabled())
+      f.counters = perf::read();
+    if (trace::enabled())
+      f.begin = trace::clock::now();
+    return index;
+  }
+
+  void profile::end(size_t index, double micros)
+  {
+    const perf::sample counters = perf::read();
+    const trace::clock::time_point now = trace::enabled() ? trace::clock::now() : trace::clock::time_point();
+    const auto it = std::find_if(m_stack.begin(), m_stack.end(), [index](const frame &f) { return f.index == index; });
+
+    phase &p = m_phases[index];
+    p.micros += micros;
+    ++p.calls;
+
+    // a phase closed by the early stop of an enclosing one has no frame left
+    memory::tracker *tracker = memory::current();
+    if (tracker && it != m_stack.end())
+    {
+      const memory::usage usage = tracker->end(it->start);
+      p.memory.allocations += usage.allocations;
+      p.memory.bytes += usage.bytes;
+      p.memory.peak = std::max(p.memory.peak, usage.peak);
+    }
+
+    if (!counters.empty() && it != m_stack.end())
+      p.counters += counters - it->counters;
+
+    if (now != trace::clock::time_point() && it != m_stack.end())
+      trace::record(it->name, "phase", it->begin, now);
+
+    // phases stopped early may close out of order, drop everything they enclose
+    m_stack.erase(it, m_stack.end());
+  }
+
+  void profile::clear()
+  {
+    m_phases.clear();
+    m_stack.clear();
+  }
+}
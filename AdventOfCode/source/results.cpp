@@ -0,0 +1,355 @@
+#include "AdventOfCode.hpp"
+
+#include "json.hpp"
+#include "results.hpp"
+
+namespace aoc::results
+{
+  namespace
+  {
+    constexpr const char *csv_header =
+      "day,phase,runs,min_us,median_us,p90_us,p99_us,max_us,stddev_us,calls,"
+      "allocations,bytes,peak_bytes,peak_rss,cycles,instructions,cache_misses,branch_misses,cached,answers,error,input";
+
+    void write_csv_field(std::ostream &out, std::string_view str)
+    {
+      if (str.find_first_of(",\"\r\n") == std::string_view::npos)
+      {
+        out << str;
+        return;
+      }
+
+      out << '"';
+      for (char c : str)
+      {
+        if (c == '"')
+          out << '"';
+        out << c;
+      }
+      out << '"';
+    }
+
+    // "parse/rules" for the phase "rules" inside "parse"
+    std::string phase_path(const std::vector<phase> &phases, size_t index)
+    {
+      std::string path = phases[index].name;
+      for (size_t i = phases[index].parent; i != phase::npos; i = phases[i].parent)
+        path = phases[i].name + '/' + path;
+      return path;
+    }
+
+    void write_json_memory(std::ostream &out, const memory::usage &usage)
+    {
+      out << "{\"allocations\":" << usage.allocations << ",\"bytes\":" << usage.bytes << ",\"peak\":" << usage.peak << '}';
+    }
+
+    void write_json_counters(std::ostream &out, const perf::sample &counters)
+    {
+      out << '{';
+      bool first = true;
+      for (size_t i = 0; i < perf::event_count; ++i)
+      {
+        if (!counters.has(perf::event(i)))
+          continue;
+
+        if (!first)
+          out << ',';
+        first = false;
+
+        std::string key = perf::event_names[i];
+        std::replace(key.begin(), key.end(), ' ', '_');
+        out << '"' << key << "\":" << counters.values[i];
+      }
+      out << '}';
+    }
+
+    void write_json(std::ostream &out, const result &res)
+    {
+      out << "{\"day\":";
+      json::write_string(out, res.problem->name);
+
+      if (!res.input.empty())
+      {
+        out << ",\"input\":";
+        json::write_string(out, res.input);
+      }
+
+      if (!res.error.empty())
+      {
+        out << ",\"error\":";
+        json::write_string(out, res.error);
+        out << "}\n";
+        return;
+      }
+
+      if (res.cached)
+        out << ",\"cached\":true";
+
+      out << ",\"answers\":[";
+      bool first = true;
+      for (const std::string &line : res.output)
+      {
+        if (!first)
+          out << ',';
+        first = false;
+        json::write_string(out, line);
+      }
+      out << ']';
+
+      const stats &s = res.stats;
+      out
+        << ",\"runs\":" << s.count
+        << ",\"min\":" << s.min
+        << ",\"median\":" << s.median
+        << ",\"p90\":" << s.p90
+        << ",\"p99\":" << s.p99
+        << ",\"max\":" << s.max
+        << ",\"mean\":" << s.mean
+        << ",\"stddev\":" << s.stddev;
+
+      if (res.peak_rss)
+      {
+        out << ",\"memory\":";
+        write_json_memory(out, res.memory);
+        out << ",\"peak_rss\":" << res.peak_rss;
+      }
+      if (!res.counters.empty())
+      {
+        out << ",\"counters\":";
+        write_json_counters(out, res.counters);
+      }
+
+      out << ",\"phases\":[";
+      for (size_t i = 0; i < res.phases.size(); ++i)
+      {
+        const phase &p = res.phases[i];
+
+        if (i > 0)
+          out << ',';
+        out << "{\"name\":";
+        json::write_string(out, phase_path(res.phases, i));
+        out << ",\"calls\":" << p.calls << ",\"median\":" << p.micros;
+
+        if (res.peak_rss)
+        {
+          out << ",\"memory\":";
+          write_json_memory(out, p.memory);
+        }
+        if (!p.counters.empty())
+        {
+          out << ",\"counters\":";
+          write_json_counters(out, p.counters);
+        }
+        out << '}';
+      }
+      out << "]}\n";
+    }
+
+    // The columns from "calls" to "branch_misses"
+    void write_csv_measures(std::ostream &out, size_t calls, const memory::usage *usage, size_t peak_rss, const perf::sample &counters)
+    {
+      out << ',' << calls;
+
+      if (usage)
+        out << ',' << usage->allocations << ',' << usage->bytes << ',' << usage->peak;
+      else
+        out << ",,,";
+
+      out << ',';
+      if (peak_rss)
+        out << peak_rss;
+
+      for (size_t i = 0; i < perf::event_count; ++i)
+      {
+        out << ',';
+        if (counters.has(perf::event(i)))
+          out << counters.values[i];
+      }
+    }
+
+    void write_csv(std::ostream &out, const result &res)
+    {
+      write_csv_field(out, res.problem->name);
+
+      if (!res.error.empty())
+      {
+        out << ",,,,,,,,,,,,,,,,,,,,";
+        write_csv_field(out, res.error);
+        out << ',';
+        write_csv_field(out, res.input);
+        out << '\n';
+        return;
+      }
+
+      const stats &s = res.stats;
+      out << ",," << s.count << ',' << s.min << ',' << s.median << ',' << s.p90 << ',' << s.p99 << ',' << s.max << ',' << s.stddev;
+      write_csv_measures(out, 1, res.peak_rss ? &res.memory : nullptr, res.peak_rss, res.counters);
+
+      // one row per problem, whatever its number of answers
+      std::string answers;
+      for (const std::string &line : res.output)
+        answers += (answers.empty() ? "" : " | ") + line;
+      out << ',' << (res.cached ? 1 : 0) << ',';
+      write_csv_field(out, answers);
+      out << ",,";
+      write_csv_field(out, res.input);
+      out << '\n';
+
+      for (size_t i = 0; i < res.phases.size(); ++i)
+      {
+        const phase &p = res.phases[i];
+
+        write_csv_field(out, res.problem->name);
+        out << ',';
+        write_csv_field(out, phase_path(res.phases, i));
+        out << ",,," << p.micros << ",,,,";
+        write_csv_measures(out, p.calls, res.peak_rss ? &p.memory : nullptr, 0, p.counters);
+        out << ",,,,";
+        write_csv_field(out, res.input);
+        out << '\n';
+      }
+    }
+
+    std::vector<std::string> split_csv(std::string_view line)
+    {
+      std::vector<std::string> fields(1);
+
+      bool quoted = false;
+      for (size_t i = 0; i < line.size(); ++i)
+      {
+        const char c = line[i];
+
+        if (quoted)
+        {
+          if (c != '"')
+            fields.back() += c;
+          else if (i + 1 < line.size() && line[i + 1] == '"')
+            fields.back() += line[++i];
+          else
+            quoted = false;
+        }
+        else if (c == '"')
+          quoted = true;
+        else if (c == ',')
+          fields.emplace_back();
+        else
+          fields.back() += c;
+      }
+      return fields;
+    }
+
+    // The string value of `"key":` in a line written by write_json, the first occurrence is the top level one
+    std::string json_string(std::string_view line, std::string_view key)
+    {
+      const size_t pos = line.find("\"" + std::string(key) + "\":\"");
+      if (pos == std::string_view::npos)
+        return {};
+
+      std::string value;
+      for (size_t i = pos + key.size() + 4; i < line.size() && line[i] != '"'; ++i)
+      {
+        if (line[i] == '\\' && i + 1 < line.size())
+          ++i;
+        value += line[i];
+      }
+      return value;
+    }
+
+    std::optional<double> json_number(std::string_view line, std::string_view key)
+    {
+      const std::string pattern = "\"" + std::string(key) + "\":";
+      const size_t pos = line.find(pattern);
+      if (pos == std::string_view::npos)
+        return std::nullopt;
+
+      const std::string value(line.substr(pos + pattern.size(), 32));
+      char *end = nullptr;
+      const double number = std::strtod(value.c_str(), &end);
+      if (end == value.c_str())
+        return std::nullopt;
+      return number;
+    }
+  }
+
+  format format_of(const std::filesystem::path &path)
+  {
+    return (path.extension() == ".csv") ? format::csv : format::json;
+  }
+
+  void write(std::ostream &out, std::vector<result> &results, format fmt)
+  {
+    out << std::setprecision(12);
+
+    if (fmt == format::csv)
+      out << csv_header << '\n';
+
+    for (result &res : results)
+    {
+      res.output.flush();
+
+      if (fmt == format::csv)
+        write_csv(out, res);
+      else
+        write_json(out, res);
+    }
+  }
+
+  std::map<std::string, double> read_medians(const std::filesystem::path &path)
+  {
+    std::ifstream file(path);
+    if (!file)
+      throw "Can't open results file '" + path.string() + "': " + std::strerror(errno);
+
+    std::map<std::string, double> medians;
+    std::string line;
+
+    // a csv file starts with its header, a json one with an object
+    if (!std::getline(file, line))
+      return medians;
+
+    if (line.starts_with('{'))
+    {
+      do
+      {
+        const std::string day = json_string(line, "day");
+        const std::optional<double> median = json_number(line, "median");
+
+        // a quote within a string is escaped: only the top level field can match
+        const bool cached = line.find("\"cached\":true") != std::string::npos;
+
+        if (!day.empty() && median && !cached)
+          medians[day] = *median;
+      } while (std::getline(file, line));
+      return medians;
+    }
+
+    const std::vector<std::string> header = split_csv(line);
+    const auto column = [&header, &path](std::string_view name)
+    {
+      const auto it = std::find(header.begin(), header.end(), name);
+      if (it == header.end())
+        throw "Invalid results file '" + path.string() + "': no " + std::string(name) + " column";
+      return size_t(it - header.begin());
+    };
+
+    const size_t day_column = column("day");
+    const size_t phase_column = column("phase");
+    const size_t median_column = column("median_us");
+
+    // files written before the column was added hold no cached result
+    const auto cached_it = std::find(header.begin(), header.end(), "cached");
+    const size_t cached_column = size_t(cached_it - header.begin());
+
+    while (std::getline(file, line))
+    {
+      const std::vector<std::string> fields = split_csv(line);
+
+      if (fields.size() <= median_column || !fields[phase_column].empty() || fields[median_column].empty())
+        continue;
+      if (cached_column < fields.size() && fields[cached_column] == "1")
+        continue;
+      medians[fields[day_column]] = std::strtod(fields[median_column].c_str(), nullptr);
+    }
+    return medians;
+  }
+}
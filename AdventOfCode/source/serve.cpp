@@ -0,0 +1,325 @@
+#include "AdventOfCode.hpp"
+
+#include "serve.hpp"
+
+#include <semaphore>
+
+#ifdef UNIX
+# include <fcntl.h>
+# include <signal.h>
+# include <unistd.h>
+# include <sys/un.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/socket.h>
+#endif
+
+namespace aoc::serve
+{
+#ifdef UNIX
+  namespace
+  {
+    constexpr uint32_t magic = 0x31434F41; // "AOC1"
+
+    // the sockets are local: the headers are in the native byte order
+    struct request_header
+    {
+      uint32_t magic;
+      uint32_t name_size;
+      uint64_t input_size;
+    };
+
+    struct response_header
+    {
+      uint32_t magic;
+      uint32_t solved;
+      double   micros;
+      uint64_t text_size;
+    };
+
+    constexpr uint32_t max_name_size = 64;
+    constexpr uint64_t max_input_size = uint64_t(1) << 30;
+
+    // connections served at once, the next ones wait in the socket's backlog
+    constexpr ptrdiff_t max_connections = 64;
+
+    bool read_all(int fd, void *data, size_t size)
+    {
+      char *bytes = static_cast<char *>(data);
+      while (size > 0)
+      {
+        const ssize_t count = ::read(fd, bytes, size);
+        if (count < 0 && errno == EINTR)
+          continue;
+        if (count <= 0)
+          return false;
+
+        bytes += count;
+        size -= size_t(count);
+      }
+      return true;
+    }
+
+    bool write_all(int fd, const void *data, size_t size)
+    {
+      const char *bytes = static_cast<const char *>(data);
+      while (size > 0)
+      {
+        const ssize_t count = ::write(fd, bytes, size);
+        if (count < 0 && errno == EINTR)
+          continue;
+        if (count <= 0)
+          return false;
+
+        bytes += count;
+        size -= size_t(count);
+      }
+      return true;
+    }
+
+    sockaddr_un socket_address(const std::filesystem::path &path)
+    {
+      sockaddr_un address {};
+      address.sun_family = AF_UNIX;
+
+      const std::string name = path.string();
+      if (name.size() >= sizeof(address.sun_path))
+        throw "Socket path '" + name + "' is too long";
+
+      std::memcpy(address.sun_path, name.c_str(), name.size() + 1);
+      return address;
+    }
+
+    // The solvers map their input from a file: the input of a request goes to a file in memory, when possible
+    class request_file
+    {
+    public:
+      request_file()
+      {
+#ifdef LINUX
+        m_fd = memfd_create("aoc-request", MFD_CLOEXEC);
+        if (m_fd >= 0)
+        {
+          m_path = "/proc/self/fd/" + std::to_string(m_fd);
+          return;
+        }
+#endif
+        static std::atomic<unsigned> counter = 0;
+
+        m_path = std::filesystem::temp_directory_path() / ("aoc-request-" + std::to_string(getpid()) + '-' + std::to_string(counter++));
+        m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        m_owned = true;
+        if (m_fd < 0)
+          throw "Can't create '" + m_path.string() + "': " + std::strerror(errno);
+      }
+
+      ~request_file()
+      {
+        ::close(m_fd);
+        if (m_owned)
+          ::unlink(m_path.c_str());
+      }
+
+      request_file(const request_file &) = delete;
+      request_file &operator=(const request_file &) = delete;
+
+      const std::filesystem::path &path() const { return m_path; }
+
+      bool store(std::string_view bytes)
+      {
+        if (ftruncate(m_fd, off_t(bytes.size())) < 0)
+          return false;
+
+        for (size_t offset = 0; offset < bytes.size();)
+        {
+          const ssize_t count = ::pwrite(m_fd, bytes.data() + offset, bytes.size() - offset, off_t(offset));
+          if (count < 0 && errno == EINTR)
+            continue;
+          if (count <= 0)
+            return false;
+          offset += size_t(count);
+        }
+        return true;
+      }
+
+    private:
+      int                   m_fd = -1;
+      std::filesystem::path m_path;
+      bool                  m_owned = false;
+    };
+
+    void send_response(int fd, const response &res)
+    {
+      const response_header header { magic, res.solved ? 1u : 0u, res.micros, res.text.size() };
+
+      if (write_all(fd, &header, sizeof(header)))
+        write_all(fd, res.text.data(), res.text.size());
+    }
+
+    // Until the client hangs up or sends something that is not a request
+    void serve_connection(int fd, const handler &handle)
+    {
+      try
+      {
+        request_file file;
+        std::string name;
+        std::string input; // kept from one request to the next, like the solvers' arena on this thread
+
+        request_header header;
+        while (read_all(fd, &header, sizeof(header)))
+        {
+          if (header.magic != magic || header.name_size > max_name_size || header.input_size > max_input_size)
+            break;
+
+          name.resize(header.name_size);
+          input.resize(size_t(header.input_size));
+          if (!read_all(fd, name.data(), name.size()) || !read_all(fd, input.data(), input.size()))
+            break;
+
+          response res;
+          if (!file.store(input))
+            res.text = "Can't store the input: " + std::string(std::strerror(errno));
+          else
+          {
+            try
+            {
+              res = handle(name, file.path());
+            }
+            catch (std::string &err)
+            {
+              res = { false, 0, err };
+            }
+          }
+          send_response(fd, res);
+        }
+      }
+      catch (std::string &err)
+      {
+        send_response(fd, { false, 0, err });
+      }
+      ::close(fd);
+    }
+  }
+
+  bool supported()
+  {
+    return true;
+  }
+
+  void listen(const std::filesystem::path &path, const handler &handle)
+  {
+    // a client hanging up must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    const sockaddr_un address = socket_address(path);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+      throw std::string("Can't create the socket: ") + std::strerror(errno);
+
+    // left behind by a server that was stopped
+    struct stat st;
+    if (::stat(address.sun_path, &st) == 0 && S_ISSOCK(st.st_mode))
+      ::unlink(address.sun_path);
+
+    if (::bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0 || ::listen(fd, SOMAXCONN) < 0)
+    {
+      const int err = errno;
+      ::close(fd);
+      throw "Can't listen on '" + path.string() + "': " + std::strerror(err);
+    }
+
+    std::counting_semaphore<max_connections> slots(max_connections);
+    for (;;)
+    {
+      slots.acquire();
+
+      const int connection = ::accept(fd, nullptr, nullptr);
+      if (connection < 0)
+      {
+        slots.release();
+        continue;
+      }
+
+      try
+      {
+        std::thread([connection, &handle, &slots]
+        {
+          serve_connection(connection, handle);
+          slots.release();
+        }).detach();
+      }
+      catch (std::system_error &)
+      {
+        ::close(connection);
+        slots.release();
+      }
+    }
+  }
+
+  client::client(const std::filesystem::path &path)
+  {
+    const sockaddr_un address = socket_address(path);
+
+    m_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_socket < 0)
+      throw std::string("Can't create the socket: ") + std::strerror(errno);
+
+    if (::connect(m_socket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0)
+    {
+      const int err = errno;
+      ::close(m_socket);
+      throw "Can't connect to '" + path.string() + "': " + std::strerror(err);
+    }
+  }
+
+  client::~client()
+  {
+    ::close(m_socket);
+  }
+
+  response client::solve(std::string_view name, std::string_view input)
+  {
+    if (name.size() > max_name_size)
+      throw "Problem name '" + std::string(name) + "' is too long";
+
+    const request_header request { magic, uint32_t(name.size()), input.size() };
+    if (!write_all(m_socket, &request, sizeof(request)) || !write_all(m_socket, name.data(), name.size()) || !write_all(m_socket, input.data(), input.size()))
+      throw std::string("Can't send the request: ") + std::strerror(errno);
+
+    response_header header;
+    if (!read_all(m_socket, &header, sizeof(header)) || header.magic != magic)
+      throw std::string("The server closed the connection");
+
+    response res;
+    res.solved = (header.solved != 0);
+    res.micros = header.micros;
+    res.text.resize(size_t(header.text_size));
+    if (!read_all(m_socket, res.text.data(), res.text.size()))
+      throw std::string("The server closed the connection");
+    return res;
+  }
+#else
+  bool supported()
+  {
+    return false;
+  }
+
+  void listen(const std::filesystem::path &, const handler &)
+  {
+    throw std::string("The server needs Unix domain sockets, not available on this platform");
+  }
+
+  client::client(const std::filesystem::path &)
+  {
+    throw std::string("The client needs Unix domain sockets, not available on this platform");
+  }
+
+  client::~client() = default;
+
+  response client::solve(std::string_view, std::string_view)
+  {
+    return {};
+  }
+#endif
+}
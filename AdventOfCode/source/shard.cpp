@@ -0,0 +1,272 @@
+#include "AdventOfCode.hpp"
+
+#include "shard.hpp"
+
+#ifdef UNIX
+# include <sched.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/wait.h>
+#endif
+
+namespace aoc::shard
+{
+#ifdef UNIX
+  namespace
+  {
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "the shared counters must not hide a lock");
+
+    constexpr size_t   ring_size = 16;
+    constexpr uint64_t no_item = uint64_t(-1);
+
+    struct message
+    {
+      uint64_t index;
+      uint32_t size;
+      uint32_t truncated; // the payload was longer than data
+      char     data[payload_capacity];
+    };
+
+    // Written by a single worker, read by the parent
+    struct ring
+    {
+      alignas(exec::cache_line) std::atomic<uint64_t> head = 0;          // messages sent
+      alignas(exec::cache_line) std::atomic<uint64_t> tail = 0;          // messages received
+      alignas(exec::cache_line) std::atomic<uint64_t> current = no_item; // item being worked on
+      message messages[ring_size];
+    };
+
+    // The rings of the workers follow it in the same mapping
+    struct queue
+    {
+      alignas(exec::cache_line) std::atomic<uint64_t> next = 0; // next item to claim
+    };
+
+    void wait()
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+
+    // The cores this process may run on
+    std::vector<int> allowed_cores()
+    {
+      std::vector<int> cores;
+
+#ifdef LINUX
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      if (sched_getaffinity(0, sizeof(set), &set) == 0)
+      {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+          if (CPU_ISSET(cpu, &set))
+            cores.push_back(cpu);
+      }
+#endif
+
+      if (cores.empty())
+      {
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu)
+          cores.push_back(int(cpu));
+      }
+      return cores;
+    }
+
+    // A contiguous share of the cores for each worker, workers share a core when there are more of them
+    std::vector<int> core_set(const std::vector<int> &cores, size_t worker, size_t workers)
+    {
+      if (workers >= cores.size())
+        return { cores[worker % cores.size()] };
+
+      const size_t begin = worker * cores.size() / workers;
+      const size_t end = (worker + 1) * cores.size() / workers;
+      return std::vector<int>(cores.begin() + begin, cores.begin() + end);
+    }
+
+    // macOS only takes affinity hints between threads, its workers are left where the scheduler puts them
+    void pin(const std::vector<int> &cores)
+    {
+#ifdef LINUX
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (int cpu : cores)
+        CPU_SET(cpu, &set);
+      sched_setaffinity(0, sizeof(set), &set);
+#else
+      (void)cores;
+#endif
+    }
+
+    [[noreturn]] void work_loop(queue &items, ring &out, size_t count, const worker_fn &work)
+    {
+      for (;;)
+      {
+        const uint64_t index = items.next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count)
+          break;
+
+        out.current.store(index, std::memory_order_relaxed);
+
+        std::string payload;
+        try
+        {
+          payload = work(index);
+        }
+        catch (...)
+        {
+          payload.clear(); // reported as lost
+        }
+
+        const uint64_t head = out.head.load(std::memory_order_relaxed);
+        while (head - out.tail.load(std::memory_order_acquire) >= ring_size)
+          wait();
+
+        message &msg = out.messages[head % ring_size];
+        msg.index = index;
+        msg.size = uint32_t(std::min(payload.size(), payload_capacity));
+        msg.truncated = (payload.size() > payload_capacity);
+        std::memcpy(msg.data, payload.data(), msg.size);
+
+        // published before the item is done: a worker dying in between has its item reported once, by its message
+        out.head.store(head + 1, std::memory_order_release);
+        out.current.store(no_item, std::memory_order_relaxed);
+      }
+
+      // the parent flushes the streams and runs the destructors, not its copies
+      _exit(0);
+    }
+  }
+
+  bool supported()
+  {
+    return true;
+  }
+
+  void run(size_t count, unsigned processes, const worker_fn &work, const collect_fn &collect)
+  {
+    const std::vector<int> cores = allowed_cores();
+
+    if (processes == 0)
+      processes = unsigned(cores.size());
+    processes = unsigned(std::clamp<size_t>(processes, 1, std::max<size_t>(count, 1)));
+
+    const size_t bytes = sizeof(queue) + processes * sizeof(ring);
+    void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+      throw std::string("Can't map the memory shared with the workers: ") + std::strerror(errno);
+
+    queue *items = new (memory) queue();
+    ring *rings = reinterpret_cast<ring *>(static_cast<std::byte *>(memory) + sizeof(queue));
+    for (unsigned i = 0; i < processes; ++i)
+      new (rings + i) ring();
+
+    // whatever is buffered would be written once more by every worker
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    std::vector<pid_t> workers;
+    for (unsigned i = 0; i < processes; ++i)
+    {
+      const pid_t pid = fork();
+      if (pid < 0)
+        break; // the workers already started share the items
+
+      if (pid == 0)
+      {
+        const std::vector<int> set = core_set(cores, i, processes);
+        exec::after_fork();
+        pin(set);
+        exec::set_threads(unsigned(set.size()));
+        work_loop(*items, rings[i], count, work);
+      }
+      workers.push_back(pid);
+    }
+
+    if (workers.empty())
+    {
+      const int err = errno;
+      munmap(memory, bytes);
+      throw std::string("Can't start the worker processes: ") + std::strerror(err);
+    }
+
+    std::vector<bool> done(count, false);
+    size_t collected = 0;
+
+    const auto drain = [&](ring &r)
+    {
+      bool received = false;
+      for (uint64_t tail = r.tail.load(std::memory_order_relaxed); tail != r.head.load(std::memory_order_acquire); ++tail)
+      {
+        const message &msg = r.messages[tail % ring_size];
+        if (msg.index < count && !done[msg.index])
+        {
+          done[msg.index] = true;
+          ++collected;
+          collect(size_t(msg.index), std::string_view(msg.data, msg.size), msg.truncated != 0);
+        }
+        r.tail.store(tail + 1, std::memory_order_release);
+        received = true;
+      }
+      return received;
+    };
+
+    size_t running = workers.size();
+    while (running > 0 && collected < count)
+    {
+      bool received = false;
+      for (size_t i = 0; i < workers.size(); ++i)
+        received |= drain(rings[i]);
+
+      int status = 0;
+      pid_t pid = 0;
+      while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+      {
+        const auto it = std::find(workers.begin(), workers.end(), pid);
+        if (it == workers.end())
+          continue;
+
+        ring &r = rings[it - workers.begin()];
+        drain(r);
+        *it = -1;
+        --running;
+
+        // the worker died on this item
+        const uint64_t current = r.current.load(std::memory_order_relaxed);
+        if (current < count && !done[current])
+        {
+          done[current] = true;
+          ++collected;
+          collect(size_t(current), {}, false);
+        }
+      }
+
+      if (!received)
+        wait();
+    }
+
+    for (size_t i = 0; i < workers.size(); ++i)
+      drain(rings[i]);
+
+    // left in the queue by workers that all died
+    for (size_t i = 0; i < count; ++i)
+      if (!done[i])
+        collect(i, {}, false);
+
+    for (pid_t pid : workers)
+      if (pid > 0)
+        waitpid(pid, nullptr, 0);
+
+    munmap(memory, bytes);
+  }
+#else
+  bool supported()
+  {
+    return false;
+  }
+
+  void run(size_t, unsigned, const worker_fn &, const collect_fn &)
+  {
+    throw std::string("Worker processes need fork(), not available on this platform");
+  }
+#endif
+}
@@ -0,0 +1,135 @@
+#include "AdventOfCode.hpp"
+
+#include "json.hpp"
+#include "trace.hpp"
+
+namespace aoc::trace
+{
+  namespace
+  {
+    struct event
+    {
+      std::string_view  name;
+      const char       *category;
+      clock::time_point begin;
+      clock::time_point end;
+      int64_t           index;
+      bool              instant;
+    };
+
+    // Buffers are owned by the registry: the events of a pool worker outlive its thread
+    struct buffer
+    {
+      uint32_t           tid;
+      std::string        name;
+      std::vector<event> events;
+    };
+
+    std::atomic<bool>                    tracing = false;
+    const clock::time_point              origin = clock::now();
+
+    std::mutex                           registry_mutex;
+    std::vector<std::unique_ptr<buffer>> registry;
+
+    buffer &thread_buffer()
+    {
+      thread_local buffer *local = nullptr;
+
+      if (!local)
+      {
+        std::lock_guard lock(registry_mutex);
+
+        std::unique_ptr<buffer> &b = registry.emplace_back(std::make_unique<buffer>());
+        b->tid = uint32_t(registry.size());
+        b->name = "thread " + std::to_string(b->tid);
+        b->events.reserve(4096);
+        local = b.get();
+      }
+      return *local;
+    }
+
+    double micros(clock::duration d)
+    {
+      return std::chrono::duration<double, std::micro>(d).count();
+    }
+  }
+
+  void enable()
+  {
+    tracing = true;
+  }
+
+  bool enabled()
+  {
+    return tracing;
+  }
+
+  void name_thread(std::string name)
+  {
+    thread_buffer().name = std::move(name);
+  }
+
+  void record(std::string_view name, const char *category, clock::time_point begin, clock::time_point end, int64_t index)
+  {
+    if (tracing)
+      thread_buffer().events.push_back({ name, category, begin, end, index, false });
+  }
+
+  void instant(std::string_view name, const char *category)
+  {
+    if (!tracing)
+      return;
+
+    const clock::time_point now = clock::now();
+    thread_buffer().events.push_back({ name, category, now, now, -1, true });
+  }
+
+  void write(const std::filesystem::path &path)
+  {
+    std::ofstream out(path);
+    if (!out)
+      throw "Can't open trace file '" + path.string() + "': " + std::strerror(errno);
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    std::lock_guard lock(registry_mutex);
+
+    bool first = true;
+    const auto separate = [&first, &out]()
+    {
+      if (!first)
+        out << ",\n";
+      first = false;
+    };
+
+    for (const std::unique_ptr<buffer> &b : registry)
+    {
+      separate();
+      out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << b->tid << ",\"args\":{\"name\":";
+      json::write_string(out, b->name);
+      out << "}}";
+
+      for (const event &e : b->events)
+      {
+        separate();
+        out << "{\"name\":";
+        json::write_string(out, e.name);
+        out << ",\"cat\":\"" << e.category << "\",\"pid\":1,\"tid\":" << b->tid << ",\"ts\":" << micros(e.begin - origin);
+
+        if (e.instant)
+          out << ",\"ph\":\"i\",\"s\":\"t\"";
+        else
+          out << ",\"ph\":\"X\",\"dur\":" << micros(e.end - e.begin);
+
+        if (e.index >= 0)
+          out << ",\"args\":{\"index\":" << e.index << '}';
+        out << '}';
+      }
+    }
+    out << "\n]}\n";
+
+    if (!out)
+      throw "Can't write trace file '" + path.string() + "'";
+  }
+}
@@ -33,6 +33,7 @@ project "Day 01"
   }
 
   defines {
+    "DAY_NAME=\"%{prj.name}\""
   }
 
   links {
@@ -4,117 +4,116 @@
 
 #include "AdventOfCode.hpp"
 
-using elem_type = int;
-using list_type = std::vector<elem_type>;
-
-using path = std::filesystem::path;
-
-// Binary search trough the sorted list `lst` to find `elem`.
-//   If `elem` is not present, returns the index of the first element greater than `elem`.
-//   If present, returns the index of an occurence of `elem` (not necessarily the first one).
-static size_t binary_search(const list_type &lst, const elem_type &elem)
+namespace
 {
-  size_t begin = 0;
-  size_t end = lst.size();
-  size_t mid = 0;
+  using elem_type = int;
+  using list_type = std::vector<elem_type>;
 
-  while (begin != end)
+  // Binary search trough the sorted list `lst` to find `elem`.
+  //   If `elem` is not present, returns the index of the first element greater than `elem`.
+  //   If present, returns the index of an occurence of `elem` (not necessarily the first one).
+  static size_t binary_search(const list_type &lst, const elem_type &elem)
   {
-    mid = (end - begin) / 2 + begin;
-
-    if (elem < lst[mid])
-      end = mid;
-    else if (elem > lst[mid])
-      begin = ++mid;
-    else
-      break;
+    size_t begin = 0;
+    size_t end = lst.size();
+    size_t mid = 0;
+
+    while (begin != end)
+    {
+      mid = (end - begin) / 2 + begin;
+
+      if (elem < lst[mid])
+        end = mid;
+      else if (elem > lst[mid])
+        begin = ++mid;
+      else
+        break;
+    }
+    return mid;
   }
-  return mid;
-}
-
-// The list is sorted. so counting an element occurence is trivial
-static size_t count_occurrences(const list_type &lst, elem_type elem)
-{
-  size_t i = binary_search(lst, elem);
 
-  if (i >= lst.size() || lst[i] != elem)
-    return 0;
-
-  size_t count = 1;
-  while (i > 0 && lst[i - 1] == elem)
+  // The list is sorted. so counting an element occurence is trivial
+  static size_t count_occurrences(const list_type &lst, elem_type elem)
   {
-    ++count;
-    --i;
-  }
-  while (i + count < lst.size() && lst[i + count] == elem)
-    ++count;
+    size_t i = binary_search(lst, elem);
 
-  return count;
-}
+    if (i >= lst.size() || lst[i] != elem)
+      return 0;
 
-// Read the input file and insert the elements in the lists in sorted order
-static void load_lists(path filepath, list_type &list_a, list_type &list_b)
-{
-  if (!std::filesystem::exists(filepath))
-    throw "Input file " + filepath.string() + " does not exist";
+    size_t count = 1;
+    while (i > 0 && lst[i - 1] == elem)
+    {
+      ++count;
+      --i;
+    }
+    while (i + count < lst.size() && lst[i + count] == elem)
+      ++count;
 
-  std::ifstream ifs(filepath);
+    return count;
+  }
 
-  if (!ifs.is_open())
-    throw "Can't open input file '" + filepath.string() + "': " + strerror(errno);
+  // Read the input file and insert the elements in the lists in sorted order
+  static void load_lists(const std::filesystem::path &path, list_type &list_a, list_type &list_b)
+  {
+    aoc::scoped_timer timer("parse");
+
+    const aoc::input input(path);
+    std::string_view data = input.view();
+
+    elem_type a;
+    elem_type b;
+    while (aoc::parse::next(data, a) && aoc::parse::next(data, b))
+    {
+      // insert elements in sorted position
+      list_a.emplace(
+        list_a.begin() + binary_search(list_a, a),
+        std::move(a)
+      );
+      list_b.emplace(
+        list_b.begin() + binary_search(list_b, b),
+        std::move(b)
+      );
+    }
+
+    assert(list_a.size() == list_b.size());
+    assert(std::is_sorted(list_a.begin(), list_a.end()));
+    assert(std::is_sorted(list_b.begin(), list_b.end()));
+  }
 
-  elem_type a;
-  elem_type b;
-  while (ifs >> a >> b)
+  void solve(const aoc::context &ctx)
   {
-    // insert elements in sorted position
-    list_a.emplace(
-      list_a.begin() + binary_search(list_a, a),
-      std::move(a)
+    list_type list_a;
+    list_type list_b;
+    list_type results;
+
+    load_lists(ctx.input, list_a, list_b);
+    results.resize(list_a.size());
+
+    // Compute distance
+    aoc::scoped_timer part1("part 1");
+    std::transform(
+      list_a.begin(), list_a.end(),
+      list_b.begin(),
+      results.begin(),
+      [](elem_type &a, elem_type &b) { return std::abs(a - b); }
     );
-    list_b.emplace(
-      list_b.begin() + binary_search(list_b, b),
-      std::move(b)
+    const int distance = std::reduce(results.cbegin(), results.cend());
+    part1.stop();
+
+    // Compute similarity
+    aoc::scoped_timer part2("part 2");
+    std::transform(
+      list_a.begin(), list_a.end(),
+      results.begin(),
+      [&list_b](elem_type &a) { return a * (int)count_occurrences(list_b, a); }
     );
-  }
+    const int similarity = std::reduce(results.cbegin(), results.cend());
+    part2.stop();
 
-  assert(list_a.size() == list_b.size());
-  assert(std::is_sorted(list_a.begin(), list_a.end()));
-  assert(std::is_sorted(list_b.begin(), list_b.end()));
-}
-
-void solve()
-{
-  list_type list_a;
-  list_type list_b;
-  list_type results;
-
-  load_lists("assets/input.txt", list_a, list_b);
-  results.resize(list_a.size());
-
-  // Compute distance
-  std::transform(
-    list_a.begin(), list_a.end(),
-    list_b.begin(),
-    results.begin(),
-    [](elem_type &a, elem_type &b) { return std::abs(a - b); }
-  );
-  const int distance = std::reduce(results.cbegin(), results.cend());
-
-  // Compute similarity
-  std::transform(
-    list_a.begin(), list_a.end(),
-    results.begin(),
-    [&list_b](elem_type &a) { return a * (int)count_occurrences(list_b, a); }
-  );
-  const int similarity = std::reduce(results.cbegin(), results.cend());
-
-  // Display results
-  aoc::cout << "Distance:   " << distance << '\n';
-  aoc::cout << "Similarity: " << similarity << '\n';
+    // Display results
+    aoc::cout << "Distance:   " << distance << '\n';
+    aoc::cout << "Similarity: " << similarity << '\n';
+  }
 }
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
-}
\ No newline at end of file
+static const aoc::problem problem(DAY_NAME, solve);
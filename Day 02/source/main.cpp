@@ -4,94 +4,91 @@
 
 #include "AdventOfCode.hpp"
 
-using Level = u8;
-
-using Report = std::vector<Level>;
-
-constexpr Level SAFETY_TRESHOLD = 3;
-
-constexpr const char *const filepath = "assets/input.txt";
-
-static bool is_safe_report(const Report &report, int ignored = -1)
+namespace
 {
-  bool increasing = true;
-  bool decreasing = true;
+  using Level = u8;
 
-  if (report.size() < 2)
-    return true;
+  using Report = std::vector<Level>;
 
-  const bool skip_first = (ignored == 0);
+  constexpr Level SAFETY_TRESHOLD = 3;
 
-  Level a = report[skip_first];
-  for (int i = 1 + skip_first; i < report.size(); ++i)
+  static bool is_safe_report(const Report &report, int ignored = -1)
   {
-    if (i == ignored)
-      continue;
-
-    const Level b = report[i];
-
-    if (a == b || abs(a - b) > SAFETY_TRESHOLD)
-      return false;
-
-    if (a > b)
-      increasing = false;
-
-    if (a < b)
-      decreasing = false;
-
-    a = b;
-  }
-
-  return (increasing || decreasing);
-}
+    bool increasing = true;
+    bool decreasing = true;
 
-static bool is_dampened_safe_report(const Report &report)
-{
-  for (int ign = 0; ign < report.size(); ++ign)
-    if (is_safe_report(report, ign))
+    if (report.size() < 2)
       return true;
-  return false;
-}
-
-void solve()
-{
-  if (!std::filesystem::exists(filepath))
-    throw "Input file " + std::string(filepath) + " does not exist";
 
-  std::ifstream ifs(filepath);
+    const bool skip_first = (ignored == 0);
 
-  if (!ifs.is_open())
-    throw "Can't open input file '" + std::string(filepath) + "': " + strerror(errno);
+    Level a = report[skip_first];
+    for (int i = 1 + skip_first; i < report.size(); ++i)
+    {
+      if (i == ignored)
+        continue;
 
-  size_t safeCount = 0;
-  size_t dampenedSafeCount = 0;
+      const Level b = report[i];
 
-  Report report;
+      if (a == b || abs(a - b) > SAFETY_TRESHOLD)
+        return false;
 
-  int val;
-  while (ifs >> val)
-  {
-    report.emplace_back(val);
+      if (a > b)
+        increasing = false;
 
-    const char next = ifs.peek();
-    if (next != '\n' && !ifs.eof())
-      continue;
+      if (a < b)
+        decreasing = false;
 
-    if (is_safe_report(report))
-      ++safeCount;
-    else
-      dampenedSafeCount += is_dampened_safe_report(report);
+      a = b;
+    }
 
-    report.clear();
+    return (increasing || decreasing);
   }
 
-  dampenedSafeCount += safeCount;
+  static bool is_dampened_safe_report(const Report &report)
+  {
+    for (int ign = 0; ign < report.size(); ++ign)
+      if (is_safe_report(report, ign))
+        return true;
+    return false;
+  }
 
-  aoc::cout << safeCount << " safe reports." << '\n';
-  aoc::cout << dampenedSafeCount << " dampened safe reports." << '\n';
+  void solve(const aoc::context &ctx)
+  {
+    const aoc::input input(ctx.input);
+
+    size_t safeCount = 0;
+    size_t dampenedSafeCount = 0;
+
+    // all the reports are stored back to back, `ends` delimits them
+    aoc::scoped_timer parse("parse");
+    std::vector<Level>  levels;
+    std::vector<size_t> ends;
+    aoc::parse::lists(input.view(), levels, ends);
+    parse.stop();
+
+    // both parts share the same loop
+    aoc::scoped_timer timer("solve");
+
+    Report report;
+    size_t start = 0;
+    for (size_t end : ends)
+    {
+      report.assign(levels.begin() + start, levels.begin() + end);
+      start = end;
+
+      if (is_safe_report(report))
+        ++safeCount;
+      else
+        dampenedSafeCount += is_dampened_safe_report(report);
+    }
+    timer.stop();
+
+    dampenedSafeCount += safeCount;
+
+    aoc::cout << safeCount << " safe reports." << '\n';
+    aoc::cout << dampenedSafeCount << " dampened safe reports." << '\n';
+  }
 }
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
-}
+static const aoc::problem problem(DAY_NAME, solve);
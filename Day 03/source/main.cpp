@@ -4,103 +4,70 @@
 
 #include "AdventOfCode.hpp"
 
-constexpr const char *const filepath = "assets/input.txt";
-
-#define do_regex   R"(do\(\))"
-#define dont_regex R"(don't\(\))"
-#define mul_regex  R"(mul\(([0-9]{1,3}),([0-9]{1,3})\))"
-
-constexpr const char *const complete_regex = "(?:" do_regex "|" dont_regex "|" mul_regex ")";
-
-constexpr const char *const valid_chars = "mul(01234,56789)don't";
-
-constexpr size_t buffer_size = 4096;
-
-using Pair = std::tuple<bool, int, int>;
-using PairList = std::vector<Pair>;
-
-static void load_input(const char *path, PairList &pairs)
+namespace
 {
-  if (!std::filesystem::exists(path))
-    throw "Input file " + std::string(path) + " does not exist";
-
-  std::ifstream ifs(path);
-
-  if (!ifs.is_open())
-    throw "Can't open input file '" + std::string(filepath) + "': " + strerror(errno);
+  using namespace aoc::pattern;
 
-  pairs.clear();
+  enum instruction { DO, DONT, MUL };
 
-  const std::regex re(complete_regex);
+  // the alternatives are in `instruction` order
+  using instruction_pattern = alt<
+    lit<"do()">,
+    lit<"don't()">,
+    seq<lit<"mul(">, num<1, 3>, lit<",">, num<1, 3>, lit<")">>
+  >;
 
-  size_t pos = 0;
-  char   buffer[buffer_size + 1];
+  using Pair = std::tuple<bool, int, int>;
+  using PairList = std::vector<Pair>;
 
-  bool enabled = true;
-  do
+  static void load_input(const std::filesystem::path &path, PairList &pairs)
   {
-    ifs.read(buffer + pos, buffer_size - pos);
-    char *end = buffer + pos + ifs.gcount();
-    *end = 0;
+    aoc::scoped_timer timer("parse");
 
-    auto words_begin = std::cregex_iterator(buffer, end, re);
-    auto words_end = std::cregex_iterator();
-
-    pos = 0;
-    for (std::cregex_iterator i = words_begin; i != words_end; ++i)
-    {
-      const std::cmatch match = *i;
+    const aoc::input input(path);
 
-      pos = match.position() + match.length();
+    pairs.clear();
 
-      if (match.str() == "do()")
-        enabled = true;
-      else if (match.str() == "don't()")
-        enabled = false;
-      else
+    bool enabled = true;
+    search<instruction_pattern>(input.view(), [&pairs, &enabled](const captures<instruction_pattern> &match)
+    {
+      switch (match[0])
       {
-        const int a = std::stoi(match[1]);
-        const int b = std::stoi(match[2]);
-
-        pairs.emplace_back(enabled, a, b);
+        case DO:   enabled = true;  break;
+        case DONT: enabled = false; break;
+        case MUL:  pairs.emplace_back(enabled, int(match[1]), int(match[2])); break;
       }
-    }
-
-    const std::string_view remaining(buffer + pos, buffer_size - pos);
-    const size_t i = remaining.find_last_not_of(valid_chars);
-    if (i < buffer_size)
-      pos += (i + 1);
-
-    memmove(buffer, buffer + pos, buffer_size - pos + 1);
-    pos = buffer_size - pos;
-  } while (!ifs.eof());
-}
+    });
+  }
 
-void solve()
-{
-  PairList pairs;
-
-  load_input(filepath, pairs);
-
-  const int mult_sum = std::transform_reduce(
-    pairs.begin(), pairs.end(),
-    0,
-    std::plus{},
-    [](const Pair &p) { return std::get<1>(p) * std::get<2>(p); }
-  );
-
-  const int filtered_sum = std::transform_reduce(
-    pairs.begin(), pairs.end(),
-    0,
-    std::plus{},
-    [](const Pair &p) { return std::get<0>(p) ? std::get<1>(p) * std::get<2>(p) : 0; }
-  );
-
-  aoc::cout << "Complete sum : " << mult_sum << '\n';
-  aoc::cout << "Filtered sum : " << filtered_sum << '\n';
+  void solve(const aoc::context &ctx)
+  {
+    PairList pairs;
+
+    load_input(ctx.input, pairs);
+
+    aoc::scoped_timer part1("part 1");
+    const int mult_sum = std::transform_reduce(
+      pairs.begin(), pairs.end(),
+      0,
+      std::plus{},
+      [](const Pair &p) { return std::get<1>(p) * std::get<2>(p); }
+    );
+
+    part1.stop();
+
+    aoc::scoped_timer part2("part 2");
+    const int filtered_sum = std::transform_reduce(
+      pairs.begin(), pairs.end(),
+      0,
+      std::plus{},
+      [](const Pair &p) { return std::get<0>(p) ? std::get<1>(p) * std::get<2>(p) : 0; }
+    );
+    part2.stop();
+
+    aoc::cout << "Complete sum : " << mult_sum << '\n';
+    aoc::cout << "Filtered sum : " << filtered_sum << '\n';
+  }
 }
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
-}
+static const aoc::problem problem(DAY_NAME, solve);
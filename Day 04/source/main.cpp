@@ -4,211 +4,157 @@
 
 #include "AdventOfCode.hpp"
 
-constexpr const char *const filepath = "assets/input.txt";
-constexpr const char *const search   = "XMAS";
-constexpr const char *const x_search = search + 1;
-
-constexpr int read_size = 4096;
-
-#define BIT(x) (1 << x)
-
-using Dir = int;
-
-constexpr Dir UP    = BIT(0);
-constexpr Dir DOWN  = BIT(1);
-constexpr Dir RIGHT = BIT(2);
-constexpr Dir LEFT  = BIT(3);
-
-struct Input
+namespace
 {
-  size_t width = 0;
-  size_t height = 0;
-  std::string data;
-};
-
-static size_t read(std::istream &is, char *buffer, size_t size)
-{
-  is.read(buffer, size);
-  return is.gcount();
-}
-
-static char *strchrnul(const char *p, int c)
-{
-  while (*p && *p != c)
-    ++p;
-  return const_cast<char *>(p);
-}
+  constexpr const char *const search   = "XMAS";
+  constexpr const char *const x_search = search + 1;
 
-static Input load_file(const char *path)
-{
-  if (!std::filesystem::exists(path))
-    throw "Input file " + std::string(path) + " does not exist";
+#define BIT(x) (1 << x)
 
-  std::ifstream ifs(path);
+  using Dir = int;
 
-  if (!ifs.is_open())
-    throw "Can't open input file '" + std::string(filepath) + "': " + strerror(errno);
+  constexpr Dir UP    = BIT(0);
+  constexpr Dir DOWN  = BIT(1);
+  constexpr Dir RIGHT = BIT(2);
+  constexpr Dir LEFT  = BIT(3);
 
-  Input result;
+  // The grid is searched in place, in the mapped file.
+  // Rows are `stride` bytes apart, the line terminators never match a letter
+  using Input = aoc::input;
 
-  result.height = !ifs.eof(); // line count start from 1, but only if the file isn't empty
+  template<Dir dir>
+  static int dir_to_offset(const Input &input)
+  {
+    int result = 0;
+
+    if constexpr (dir & RIGHT)
+      result += 1;
+    if constexpr (dir & LEFT)
+      result -= 1;
+    if constexpr (dir & DOWN)
+      result += (int)input.stride();
+    if constexpr (dir & UP)
+      result -= (int)input.stride();
+    return result;
+  }
 
-  size_t count = 0;
-  char buffer[read_size + 1];
-  while (!ifs.eof())
+  template<Dir dir>
+  static bool search_str_dir(const Input &input, int pos, const char *const needle)
   {
-    count = read(ifs, buffer, read_size);
-    buffer[count] = '\0';
+    const size_t length = strlen(needle) - 1;
+    const int x_start = int(pos % input.stride());
+    const int y_start = int(pos / input.stride());
+    const int x_end = x_start + (!!(dir & RIGHT) - !!(dir & LEFT)) * int(length);
+    const int y_end = y_start + (!!(dir & DOWN)  - !!(dir & UP))   * int(length);
 
-    const char *line_start = buffer;
-    const char *line_end;
+    if (x_end < 0 || x_end >= input.width())
+      return false;
+    if (y_end < 0 || y_end >= input.height())
+      return false;
 
-    while (*(line_end = strchrnul(line_start, '\n')))
+    const int dir_offset = dir_to_offset<dir>(input);
+    for (int i = 0; needle[i]; ++i)
     {
+      if (pos < 0 || pos >= input.size() || input.data()[pos] != needle[i])
+        return false;
 
-      result.data.append(line_start, line_end - line_start);
-      line_start = line_end + 1;
-
-      if (result.width == 0)
-        result.width = result.data.size();
-
-      if (!ifs.eof() || line_end[1]) // only add line if there is more data to be treated
-        result.height++;
+      pos += dir_offset;
     }
-
-    result.data.append(line_start, line_end - line_start);
+    return true;
   }
+#define chr search_str_dir
 
-  return result;
-}
-
-template<Dir dir>
-static int dir_to_offset(const Input &input)
-{
-  int result = 0;
-
-  if constexpr (dir & RIGHT)
-    result += 1;
-  if constexpr (dir & LEFT)
-    result -= 1;
-  if constexpr (dir & DOWN)
-    result += (int)input.width;
-  if constexpr (dir & UP)
-    result -= (int)input.width;
-  return result;
-}
-
-template<Dir dir>
-static bool search_str_dir(const Input &input, int pos, const char *const needle)
-{
-  const size_t length = strlen(needle) - 1;
-  const int x_start = int(pos % input.width);
-  const int y_start = int(pos / input.width);
-  const int x_end = x_start + (!!(dir & RIGHT) - !!(dir & LEFT)) * int(length);
-  const int y_end = y_start + (!!(dir & DOWN)  - !!(dir & UP))   * int(length);
-
-  if (x_end < 0 || x_end >= input.width)
-    return false;
-  if (y_end < 0 || y_end >= input.height)
-    return false;
-
-  const int dir_offset = dir_to_offset<dir>(input);
-  for (int i = 0; needle[i]; ++i)
+  static size_t search_str(const Input &input, int pos, const char *const needle)
   {
-    if (pos < 0 || pos >= input.data.size() || input.data[pos] != needle[i])
-      return false;
+    size_t result = 0;
 
-    pos += dir_offset;
-  }
-  return true;
-}
-#define chr search_str_dir
+    if (!*needle || input.data()[pos] != *needle)
+      return 0;
 
-static size_t search_str(const Input &input, int pos, const char *const needle)
-{
-  size_t result = 0;
+    if (!needle[1]) // if the needle is 1 character long, this is the whole match
+      return 1;
+
+    result += search_str_dir<RIGHT>(input, pos, needle);
+    result += search_str_dir<DOWN >(input, pos, needle);
+    result += search_str_dir<LEFT >(input, pos, needle);
+    result += search_str_dir<UP   >(input, pos, needle);
 
-  if (!*needle || input.data[pos] != *needle)
-    return 0;
+    result += search_str_dir<RIGHT | DOWN>(input, pos, needle);
+    result += search_str_dir<RIGHT | UP  >(input, pos, needle);
+    result += search_str_dir<LEFT  | DOWN>(input, pos, needle);
+    result += search_str_dir<LEFT  | UP  >(input, pos, needle);
+    return result;
+  }
 
-  if (!needle[1]) // if the needle is 1 character long, this is the whole match
-    return 1;
+  static size_t search_X(const Input &input, int pos, const char *const needle)
+  {
+    bool result = true;
 
-  result += search_str_dir<RIGHT>(input, pos, needle);
-  result += search_str_dir<DOWN >(input, pos, needle);
-  result += search_str_dir<LEFT >(input, pos, needle);
-  result += search_str_dir<UP   >(input, pos, needle);
+    const size_t len = strlen(needle);
+    const int half_len = int(len / 2);
 
-  result += search_str_dir<RIGHT | DOWN>(input, pos, needle);
-  result += search_str_dir<RIGHT | UP  >(input, pos, needle);
-  result += search_str_dir<LEFT  | DOWN>(input, pos, needle);
-  result += search_str_dir<LEFT  | UP  >(input, pos, needle);
-  return result;
-}
+    if (input.data()[pos] != needle[len / 2])
+      return 0;
 
-static size_t search_X(const Input &input, int pos, const char *const needle)
-{
-  bool result = true;
+    if (len == 1) // if the needle is 1 character long, this is the whole match
+      return 1;
 
-  const size_t len = strlen(needle);
-  const int half_len = int(len / 2);
+    if (len % 2 == 0)
+      throw "Needle size must be odd";
 
-  if (input.data[pos] != needle[len / 2])
-    return 0;
+    const int x = int(pos % input.stride());
+    const int y = int(pos / input.stride());
+    const int box[4] = {
+      (x - half_len), (y - half_len),
+      (x + half_len), (y + half_len)
+    };
 
-  if (len == 1) // if the needle is 1 character long, this is the whole match
-    return 1;
+    // if the X does not fit in that place
+    if (box[0] < 0 || box[1] < 0 || box[2] >= input.width() || box[3] >= input.height())
+      return 0;
 
-  if (len % 2 == 0)
-    throw "Needle size must be odd";
+    // (x, y) -> i
+    auto toi = [&input](int x, int y) { return int(x + y * input.stride()); };
 
-  const int x = int(pos % input.width);
-  const int y = int(pos / input.width);
-  const int box[4] = {
-    (x - half_len), (y - half_len),
-    (x + half_len), (y + half_len)
-  };
+    // There is 4 possible combination (2 per diagonal)
 
-  // if the X does not fit in that place
-  if (box[0] < 0 || box[1] < 0 || box[2] >= input.width || box[3] >= input.height)
-    return 0;
+    // check first diagonal
+    result = (
+         chr<RIGHT | DOWN>(input, toi(x - half_len, y - half_len), needle)
+      || chr<LEFT  | UP  >(input, toi(x + half_len, y + half_len), needle)
+    );
 
-  // (x, y) -> i
-  auto toi = [&input](int x, int y) { return int(x + y * input.width); };
+    // check second diagonal
+    result &= (
+         chr<RIGHT | UP  >(input, toi(x - half_len, y + half_len), needle)
+      || chr<LEFT  | DOWN>(input, toi(x + half_len, y - half_len), needle)
+    );
 
-  // There is 4 possible combination (2 per diagonal)
+    return result;
+  }
 
-  // check first diagonal
-  result = (
-       chr<RIGHT | DOWN>(input, toi(x - half_len, y - half_len), needle)
-    || chr<LEFT  | UP  >(input, toi(x + half_len, y + half_len), needle)
-  );
+  void solve(const aoc::context &ctx)
+  {
+    aoc::scoped_timer parse("parse");
+    const Input input(ctx.input);
+    parse.stop();
 
-  // check second diagonal
-  result &= (
-       chr<RIGHT | UP  >(input, toi(x - half_len, y + half_len), needle)
-    || chr<LEFT  | DOWN>(input, toi(x + half_len, y - half_len), needle)
-  );
+    size_t xmas = 0;
+    size_t x_mas = 0;
 
-  return result;
-}
+    aoc::scoped_timer part1("part 1");
+    for (int i = 0; i < input.size(); ++i)
+      xmas += search_str(input, i, search);
+    part1.stop();
 
-void solve()
-{
-  Input input = load_file(filepath);
+    aoc::scoped_timer part2("part 2");
+    for (int i = 0; i < input.size(); ++i)
+      x_mas += search_X(input, i, x_search);
+    part2.stop();
 
-  size_t xmas = 0;
-  size_t x_mas = 0;
-  for (int i = 0; i < input.data.size(); ++i)
-  {
-    xmas  += search_str(input, i, search);
-    x_mas += search_X(input, i, x_search);
+    aoc::cout << "Found '" << search << "' " << xmas << " times\n";
+    aoc::cout << "Found " << x_mas << " X-" << x_search << "es\n";
   }
-  aoc::cout << "Found '" << search << "' " << xmas << " times\n";
-  aoc::cout << "Found " << x_mas << " X-" << x_search << "es\n";
 }
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
-}
+static const aoc::problem problem(DAY_NAME, solve);
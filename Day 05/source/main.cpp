@@ -4,172 +4,170 @@
 
 #include "AdventOfCode.hpp"
 
-constexpr const char *const filepath = "assets/input.txt";
-
-constexpr const char *const rule_rxs = R"(^([0-9]+)\|([0-9]+)$)";
-constexpr const char *const update_rxs = R"(,?([0-9]+))";
-
-// a rule is defined by it's page number and the pages that it precedes
-using ruleset = std::set<int>;
-
-struct page
+namespace
 {
-  int weight;
-  ruleset rules;
-};
+  // "X|Y": page X goes before page Y
+  using rule_pattern = aoc::pattern::seq<aoc::pattern::num<>, aoc::pattern::lit<"|">, aoc::pattern::num<>>;
 
-struct Update
-{
-  std::map<int, page> pages;
-  std::vector<int>    pages_order;
-};
+  // a rule is defined by it's page number and the pages that it precedes
+  using ruleset = aoc::pmr::set<int>;
 
-static std::vector<ruleset> parse_rules(std::istream &is)
-{
-  std::vector<ruleset> result;
+  struct page
+  {
+    int weight;
+    ruleset rules;
+  };
 
-  std::string line;
-  std::smatch match;
-  const std::regex rule_rx(rule_rxs);
+  struct Update
+  {
+    aoc::pmr::map<int, page> pages;
+    aoc::pmr::vector<int>    pages_order;
+  };
 
-  while (std::getline(is, line) && std::regex_match(line, match, rule_rx))
+  static aoc::pmr::vector<ruleset> parse_rules(aoc::line_iterator &it)
   {
-    int X = std::stoi(match[1]);
-    int Y = std::stoi(match[2]);
+    aoc::scoped_timer timer("rules");
 
-    int max = std::max(X, Y);
-    if (result.size() <= max)
-      result.resize(max + 1);
+    aoc::pmr::vector<ruleset> result;
 
-    // register that page Y goes after page X
-    result[X].insert(Y);
-  }
+    aoc::pattern::captures<rule_pattern> match;
 
-  assert(line.size() == 0);
-  return result;
-}
+    for (; it != aoc::line_iterator(); ++it)
+    {
+      if (!aoc::pattern::match<rule_pattern>(*it, match))
+        break;
 
-std::vector<Update> parse_updates(std::istream &is, std::vector<ruleset> rules)
-{
-  std::vector<Update> result;
+      int X = int(match[0]);
+      int Y = int(match[1]);
+
+      int max = std::max(X, Y);
+      if (result.size() <= max)
+        result.resize(max + 1);
 
-  std::string line;
-  std::smatch match;
-  const std::regex update_rx(update_rxs);
+      // register that page Y goes after page X
+      result[X].insert(Y);
+    }
+
+    assert(it == aoc::line_iterator() || it->empty());
+    return result;
+  }
 
-  while (std::getline(is, line))
+  aoc::pmr::vector<Update> parse_updates(aoc::line_iterator &it, aoc::pmr::vector<ruleset> rules)
   {
-    if (line.empty())
-      continue;
+    aoc::scoped_timer timer("updates");
 
-    Update update;
+    aoc::pmr::vector<Update> result;
 
-    while (std::regex_search(line, match, update_rx))
+    for (; it != aoc::line_iterator(); ++it)
     {
-      const int page_num = std::stoi(match[1]);
+      const std::string_view line = *it;
 
-      update.pages[page_num] = { 0, rules[page_num] }; // copy assign the ruleset for the page
-      update.pages_order.emplace_back(page_num);
+      if (line.empty())
+        continue;
 
-      line = match.suffix();
-    }
-
-    // remove all useless rules (the ones that are not used in this update)
-    for (auto &[page_id, _] : update.pages)
-    {
-      std::erase_if(
-        update.pages[page_id].rules,
-        [&update](int p) { return !update.pages.contains(p); }
-      );
-    }
-    result.emplace_back(std::move(update));
-  }
+      Update update;
 
-  return result;
-}
+      // comma separated page numbers
+      aoc::parse::integers(line, update.pages_order);
 
-static std::vector<Update> parse_input(const char *path)
-{
-  if (!std::filesystem::exists(path))
-    throw "Input file " + std::string(path) + " does not exist";
+      for (int page_num : update.pages_order)
+        update.pages[page_num] = { 0, rules[page_num] }; // copy assign the ruleset for the page
 
-  std::ifstream ifs(path);
+      // remove all useless rules (the ones that are not used in this update)
+      for (auto &[page_id, _] : update.pages)
+      {
+        std::erase_if(
+          update.pages[page_id].rules,
+          [&update](int p) { return !update.pages.contains(p); }
+        );
+      }
+      result.emplace_back(std::move(update));
+    }
 
-  if (!ifs.is_open())
-    throw "Can't open input file '" + std::string(filepath) + "': " + strerror(errno);
+    return result;
+  }
 
-  std::vector<ruleset> rules = parse_rules(ifs);
+  static aoc::pmr::vector<Update> parse_input(const std::filesystem::path &path)
+  {
+    aoc::scoped_timer timer("parse");
 
-  return parse_updates(ifs, rules);
-}
+    const aoc::input input(path);
+    aoc::line_iterator it = input.lines().begin();
 
-// update the page weight and recursively propagate the change
-static void set_page_weight(Update &update, page &page, int weight)
-{
-  if (page.weight >= weight)
-    return;
+    aoc::pmr::vector<ruleset> rules = parse_rules(it);
 
-  page.weight = weight;
-  for (int p : page.rules)
-    set_page_weight(update, update.pages[p], page.weight + 1);
-}
+    return parse_updates(it, rules);
+  }
 
-static void pre_process_update(Update &update)
-{
-  for (auto &[page_id, page] : update.pages)
+  // update the page weight and recursively propagate the change
+  static void set_page_weight(Update &update, page &page, int weight)
   {
+    if (page.weight >= weight)
+      return;
+
+    page.weight = weight;
     for (int p : page.rules)
-      set_page_weight(update, page, update.pages[p].weight + 1);
+      set_page_weight(update, update.pages[p], page.weight + 1);
   }
-}
 
-void solve()
-{
-  std::vector<Update> updates = parse_input(filepath);
-
-  int middle_sorted_sum = 0;
-  int middle_unsorted_sum = 0;
+  static void pre_process_update(Update &update)
+  {
+    for (auto &[page_id, page] : update.pages)
+    {
+      for (int p : page.rules)
+        set_page_weight(update, page, update.pages[p].weight + 1);
+    }
+  }
 
-  for (Update &update : updates)
+  void solve(const aoc::context &ctx)
   {
-    pre_process_update(update);
+    aoc::pmr::vector<Update> updates = parse_input(ctx.input);
 
-    const bool sorted = std::is_sorted(
-      update.pages_order.begin(),
-      update.pages_order.end(),
-      [&update](int a, int b) { return (update.pages[a].weight < update.pages[b].weight); }
-    );
+    int middle_sorted_sum = 0;
+    int middle_unsorted_sum = 0;
 
-    if (sorted)
+    // both parts are computed in a single pass over the updates
+    aoc::scoped_timer timer("solve");
+    for (Update &update : updates)
     {
-      middle_sorted_sum += update.pages_order[update.pages_order.size() / 2];
-      //std::cout << "Sorted:";
-      //for (int p : update.pages_order)
-      //  std::cout << ' ' << p;
-      //std::cout << std::endl;
-    }
-    else
-    {
-      //std::cout << "Unsorted:";
-      //for (int p : update.pages_order)
-      //  std::cout << ' ' << p;
-      //std::cout << std::endl;
+      pre_process_update(update);
 
-      std::sort(
+      const bool sorted = std::is_sorted(
         update.pages_order.begin(),
         update.pages_order.end(),
         [&update](int a, int b) { return (update.pages[a].weight < update.pages[b].weight); }
       );
-      middle_unsorted_sum += update.pages_order[update.pages_order.size() / 2];
+
+      if (sorted)
+      {
+        middle_sorted_sum += update.pages_order[update.pages_order.size() / 2];
+        //std::cout << "Sorted:";
+        //for (int p : update.pages_order)
+        //  std::cout << ' ' << p;
+        //std::cout << std::endl;
+      }
+      else
+      {
+        //std::cout << "Unsorted:";
+        //for (int p : update.pages_order)
+        //  std::cout << ' ' << p;
+        //std::cout << std::endl;
+
+        std::sort(
+          update.pages_order.begin(),
+          update.pages_order.end(),
+          [&update](int a, int b) { return (update.pages[a].weight < update.pages[b].weight); }
+        );
+        middle_unsorted_sum += update.pages_order[update.pages_order.size() / 2];
+      }
     }
-  }
 
-  //std::cout << std::endl;
-  aoc::cout << "Sum of sorted middle pages: " << middle_sorted_sum << '\n';
-  aoc::cout << "Sum of unsorted middle pages: " << middle_unsorted_sum << '\n';
-}
+    timer.stop();
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
+    //std::cout << std::endl;
+    aoc::cout << "Sum of sorted middle pages: " << middle_sorted_sum << '\n';
+    aoc::cout << "Sum of unsorted middle pages: " << middle_unsorted_sum << '\n';
+  }
 }
+
+static const aoc::problem problem(DAY_NAME, solve);
@@ -4,309 +4,299 @@
 
 #include "AdventOfCode.hpp"
 
+namespace
+{
 #if _DEBUG
 # define DBG(...) __VA_ARGS__
 #else
 # define DBG(...)
 #endif
 
-constexpr const char *const filepath = "assets/input.txt";
-
-constexpr const char guard_dirs[] = "^>v<";
+  constexpr const char guard_dirs[] = "^>v<";
 
-constexpr const char empty_space = '.';
-constexpr const char obscacle = '#';
+  constexpr const char empty_space = '.';
+  constexpr const char obscacle = '#';
 
 #define BIT(x) (1 << x)
 
-class Direction
-{
-private:
-  enum class Value : uint8_t
+  class Direction
   {
-    UP    = BIT(0),
-    RIGHT = BIT(1),
-    DOWN  = BIT(2),
-    LEFT  = BIT(3)
-  };
+  private:
+    enum class Value : uint8_t
+    {
+      UP    = BIT(0),
+      RIGHT = BIT(1),
+      DOWN  = BIT(2),
+      LEFT  = BIT(3)
+    };
 
-public:
-  using enum Value;
+  public:
+    using enum Value;
 
-  constexpr Direction(Value direction) : m_val(direction) {}
-  constexpr Direction(char c) : m_val(UP)
-  {
-    static_assert(sizeof(guard_dirs) == 5, "CHARS must be a string of 4 characters");
-    for (int i = 0; i < 4; ++i)
+    constexpr Direction(Value direction) : m_val(direction) {}
+    constexpr Direction(char c) : m_val(UP)
     {
-      if (c == guard_dirs[i])
+      static_assert(sizeof(guard_dirs) == 5, "CHARS must be a string of 4 characters");
+      for (int i = 0; i < 4; ++i)
       {
-        m_val = static_cast<Value>(BIT(i));
-        break;
+        if (c == guard_dirs[i])
+        {
+          m_val = static_cast<Value>(BIT(i));
+          break;
+        }
       }
     }
-  }
 
-  constexpr bool operator==(Direction other) const { return (m_val == other.m_val) != 0; }
-  constexpr bool operator!=(Direction other) const { return (m_val != other.m_val) != 0; }
+    constexpr bool operator==(Direction other) const { return (m_val == other.m_val) != 0; }
+    constexpr bool operator!=(Direction other) const { return (m_val != other.m_val) != 0; }
 
-  constexpr operator char(void) const
-  {
-    switch (m_val)
+    constexpr operator char(void) const
     {
-      case UP:    return guard_dirs[0];
-      case RIGHT: return guard_dirs[1];
-      case DOWN:  return guard_dirs[2];
-      case LEFT:  return guard_dirs[3];
+      switch (m_val)
+      {
+        case UP:    return guard_dirs[0];
+        case RIGHT: return guard_dirs[1];
+        case DOWN:  return guard_dirs[2];
+        case LEFT:  return guard_dirs[3];
+      }
+      return '?';
     }
-    return '?';
-  }
 
-  constexpr operator int(void) const { return static_cast<uint8_t>(m_val); }
+    constexpr operator int(void) const { return static_cast<uint8_t>(m_val); }
 
-  constexpr aoc::vec2 vec(void) const {
-    switch (m_val)
-    {
-    case UP:    return {  0, -1 };
-    case RIGHT: return {  1,  0 };
-    case DOWN:  return {  0,  1 };
-    case LEFT:  return { -1,  0 };
+    constexpr aoc::vec2 vec(void) const {
+      switch (m_val)
+      {
+      case UP:    return {  0, -1 };
+      case RIGHT: return {  1,  0 };
+      case DOWN:  return {  0,  1 };
+      case LEFT:  return { -1,  0 };
+      }
+      return { 0, 0 };
     }
-    return { 0, 0 };
-  }
-
-  constexpr Direction operator+(int i)
-  {
-    if (i < 0)
-      return operator-(-i);
 
-    if (i > 4) i %= 4;
+    constexpr Direction operator+(int i)
+    {
+      if (i < 0)
+        return operator-(-i);
 
-    const uint8_t val = static_cast<uint8_t>(m_val);
-    return static_cast<Value>(((val << i) | (val >> (4 - i))) & 0x0f);
-  }
+      if (i > 4) i %= 4;
 
-  constexpr Direction operator-(int i)
-  {
-    if (i < 0)
-      return operator+(-i);
+      const uint8_t val = static_cast<uint8_t>(m_val);
+      return static_cast<Value>(((val << i) | (val >> (4 - i))) & 0x0f);
+    }
 
-    if (i > 4) i %= 4;
+    constexpr Direction operator-(int i)
+    {
+      if (i < 0)
+        return operator+(-i);
 
-    const uint8_t val = static_cast<uint8_t>(m_val);
-    return static_cast<Value>(((val >> i) | (val << (4 - i))) & 0x0f);
-  }
+      if (i > 4) i %= 4;
 
-  constexpr Direction &operator++(void)
-  {
-    const uint8_t val = static_cast<uint8_t>(m_val);
-    m_val = static_cast<Value>(((val << 1) | (val >> 3)) & 0x0f);
-    return *this;
-  }
+      const uint8_t val = static_cast<uint8_t>(m_val);
+      return static_cast<Value>(((val >> i) | (val << (4 - i))) & 0x0f);
+    }
 
-  constexpr Direction &operator--(void)
-  {
-    const uint8_t val = static_cast<uint8_t>(m_val);
-    m_val = static_cast<Value>(((val >> 1) | (val << 3)) & 0x0f);
-    return *this;
-  }
+    constexpr Direction &operator++(void)
+    {
+      const uint8_t val = static_cast<uint8_t>(m_val);
+      m_val = static_cast<Value>(((val << 1) | (val >> 3)) & 0x0f);
+      return *this;
+    }
 
-private:
-  Value m_val;
-};
+    constexpr Direction &operator--(void)
+    {
+      const uint8_t val = static_cast<uint8_t>(m_val);
+      m_val = static_cast<Value>(((val >> 1) | (val << 3)) & 0x0f);
+      return *this;
+    }
 
-struct Guard
-{
-  aoc::vec2 pos;
-  Direction dir = Direction::UP;
-};
+  private:
+    Value m_val;
+  };
 
-struct Map
-{
-private:
-  struct MapPrinter
+  struct Guard
   {
-    const Map &map;
-    const Guard &guard;
+    aoc::vec2 pos;
+    Direction dir = Direction::UP;
+  };
 
-    friend std::ostream &operator<<(std::ostream &os, const MapPrinter &printer)
+  struct Map
+  {
+  private:
+    struct MapPrinter
     {
-      const Map &map = printer.map;
-      const Guard &guard = printer.guard;
+      const Map &map;
+      const Guard &guard;
 
-      std::string data = map.data;
-      for (size_t i = 0; i < data.size(); ++i)
+      friend std::ostream &operator<<(std::ostream &os, const MapPrinter &printer)
       {
-        if (data[i] <= 0x0f)
-          data[i] = 'x';
+        const Map &map = printer.map;
+        const Guard &guard = printer.guard;
+
+        std::string data = map.data;
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+          if (data[i] <= 0x0f)
+            data[i] = 'x';
+        }
+
+        std::string_view line;
+        for (size_t y = 0; y < map.height; ++y)
+        {
+          line = std::string_view(&data[y * map.width], map.width);
+          if (y != guard.pos.y)
+            os << line;
+          else
+            os << line.substr(0, guard.pos.x) << char(guard.dir) << line.substr(guard.pos.x + 1);
+          os << '\n';
+        }
+
+        return os;
       }
+    };
 
-      std::string_view line;
-      for (size_t y = 0; y < map.height; ++y)
-      {
-        line = std::string_view(&data[y * map.width], map.width);
-        if (y != guard.pos.y)
-          os << line;
-        else
-          os << line.substr(0, guard.pos.x) << char(guard.dir) << line.substr(guard.pos.x + 1);
-        os << '\n';
-      }
+  public:
+    size_t width = 0;
+    size_t height = 0;
+    std::string data;
 
-      return os;
-    }
-  };
+    MapPrinter operator()(const Guard &guard) const { return MapPrinter(*this, guard); }
 
-public:
-  size_t width = 0;
-  size_t height = 0;
-  std::string data;
+    char &operator[](const aoc::vec2 &pos) { return data[pos.x + pos.y * width]; }
+    const char &operator[](const aoc::vec2 &pos) const { return data[pos.x + pos.y * width]; }
 
-  MapPrinter operator()(const Guard &guard) const { return MapPrinter(*this, guard); }
+    bool contains_pos(const aoc::vec2 &pos) const { return (pos.x >= 0 && pos.y >= 0 && pos.x < width && pos.y < height); }
 
-  char &operator[](const aoc::vec2 &pos) { return data[pos.x + pos.y * width]; }
-  const char &operator[](const aoc::vec2 &pos) const { return data[pos.x + pos.y * width]; }
+    // returns wether or not the guard is within the map's bounds
+    bool operator[](const Guard &guard) const { return contains_pos(guard.pos); }
+  };
 
-  bool contains_pos(const aoc::vec2 &pos) const { return (pos.x >= 0 && pos.y >= 0 && pos.x < width && pos.y < height); }
+  static Map load_file(const std::filesystem::path &path, Guard &guard)
+  {
+    aoc::scoped_timer timer("parse");
 
-  // returns wether or not the guard is within the map's bounds
-  bool operator[](const Guard &guard) const { return contains_pos(guard.pos); }
-};
+    const aoc::input input(path);
 
+    bool found_guard = false;
+    Map result;
 
-static size_t read(std::istream &is, char *buffer, size_t size)
-{
-  is.read(buffer, size);
-  return is.gcount();
-}
+    result.data.reserve(input.width() * input.height());
 
-static char *strchrnul(const char *p, int c)
-{
-  while (*p && *p != c)
-    ++p;
-  return const_cast<char *>(p);
-}
+    size_t x;
+    for (const std::string_view line : input.lines())
+    {
+      if (!found_guard && (x = line.find_first_of(guard_dirs)) < line.size())
+      {
+        guard.pos.x = int(x);
+        guard.pos.y = int(result.height);
+        guard.dir = line[x];
+        found_guard = true;
+      }
 
-static Map load_file(const char *path, Guard &guard)
-{
-  if (!std::filesystem::exists(path))
-    throw "Input file " + std::string(path) + " does not exist";
+      result.data.append(line);
 
-  std::ifstream ifs(path);
+      if (result.width == 0)
+        result.width = line.size();
+      else
+        assert(line.size() == result.width);
 
-  if (!ifs.is_open())
-    throw "Can't open input file '" + std::string(filepath) + "': " + strerror(errno);
+      result.height++;
+    }
+
+    // the map is written to while walking, the guard's cell is a regular empty space
+    if (found_guard)
+      result[guard.pos] = empty_space;
 
-  bool found_guard = false;
-  Map result;
+    return result;
+  }
 
-  size_t      x;
-  std::string line;
-  while (std::getline(ifs, line))
+  static bool play_turn(Map &map, Guard &guard)
   {
-    if (!found_guard && (x = line.find_first_of(guard_dirs)) < line.size())
+    bool new_cell = false;
+    char &cell = map[guard.pos];
+
+    // Remember if the guard never visited this cell
+    if (cell == empty_space)
     {
-      guard.pos.x = int(x);
-      guard.pos.y = int(result.height);
-      guard.dir = line[x];
-      line[x] = empty_space;
-      found_guard = true;
+      new_cell = true;
+      cell = 0;
     }
+    // mark the cell as visited in that direction
+    cell |= int(guard.dir);
 
-    result.data.append(line);
+    // get the guard's next position
+    aoc::vec2 next = guard.pos + guard.dir.vec();
 
-    if (result.width == 0)
-      result.width = line.size();
-    else
-      assert(line.size() == result.width);
+    // either move forward or turn right
+    if (map.contains_pos(next) && map[next] == obscacle)
+      ++guard.dir;
+    else 
+      guard.pos = next;
 
-    result.height++;
+    return new_cell;
   }
 
-  return result;
-}
+  static bool is_loop_oportunity(Map map, Guard guard)
+  {
+    aoc::scoped_timer timer("loop check");
 
-static bool play_turn(Map &map, Guard &guard)
-{
-  bool new_cell = false;
-  char &cell = map[guard.pos];
+    const aoc::vec2 front_pos = guard.pos + guard.dir.vec();
 
-  // Remember if the guard never visited this cell
-  if (cell == empty_space)
-  {
-    new_cell = true;
-    cell = 0;
-  }
-  // mark the cell as visited in that direction
-  cell |= int(guard.dir);
+    // if the guard is about to leave the map
+    if (!map.contains_pos(front_pos))
+      return false;
 
-  // get the guard's next position
-  aoc::vec2 next = guard.pos + guard.dir.vec();
+    // putting an obstacle here would change the already traced path
+    if (map[front_pos] != empty_space)
+      return false;
 
-  // either move forward or turn right
-  if (map.contains_pos(next) && map[next] == obscacle)
+    // place the obstacle and turn the guard right
+    map[front_pos] = obscacle;
+    map[guard.pos] = int(guard.dir);
     ++guard.dir;
-  else 
-    guard.pos = next;
-
-  return new_cell;
-}
 
-static bool is_loop_oportunity(Map map, Guard guard)
-{
-  const aoc::vec2 front_pos = guard.pos + guard.dir.vec();
+    // simulate untill a loop is found or the guard leaves the map
+    while (map[guard])
+    {
+      const char &cell = map[guard.pos];
+      if (cell < 0x10 && cell & int(guard.dir))
+      {
+        DBG(std::cout << "\033[32m" << map(guard) << "\033[0m" << std::endl);
+        return true;
+      }
 
-  // if the guard is about to leave the map
-  if (!map.contains_pos(front_pos))
-    return false;
+      play_turn(map, guard);
+    }
 
-  // putting an obstacle here would change the already traced path
-  if (map[front_pos] != empty_space)
     return false;
+  }
 
-  // place the obstacle and turn the guard right
-  map[front_pos] = obscacle;
-  map[guard.pos] = int(guard.dir);
-  ++guard.dir;
-
-  // simulate untill a loop is found or the guard leaves the map
-  while (map[guard])
+  void solve(const aoc::context &ctx)
   {
-    const char &cell = map[guard.pos];
-    if (cell < 0x10 && cell & int(guard.dir))
-    {
-      DBG(std::cout << "\033[32m" << map(guard) << "\033[0m" << std::endl);
-      return true;
-    }
+    Guard guard;
+    Map map = load_file(ctx.input, guard);
 
-    play_turn(map, guard);
-  }
+    const aoc::vec2 start = guard.pos;
 
-  return false;
-}
-
-void solve()
-{
-  Guard guard;
-  Map map = load_file(filepath, guard);
+    int visited_spaces = 0;
+    int loop_oportunities = 0;
 
-  const aoc::vec2 start = guard.pos;
+    // the guard's walk (part 1) checks for loop oportunities (part 2) at every step
+    aoc::scoped_timer timer("walk");
 
-  int visited_spaces = 0;
-  int loop_oportunities = 0;
+    // while the guard is within the map bounds
+    while (map[guard])
+    {
+      DBG(std::cout << map(guard) << std::endl);
+      loop_oportunities += is_loop_oportunity(map, guard);
+      visited_spaces += play_turn(map, guard);
+    }
+    timer.stop();
 
-  // while the guard is within the map bounds
-  while (map[guard])
-  {
-    DBG(std::cout << map(guard) << std::endl);
-    loop_oportunities += is_loop_oportunity(map, guard);
-    visited_spaces += play_turn(map, guard);
+    aoc::cout << "The guard visited " << visited_spaces << " cells.\n";
+    aoc::cout << "There is " << loop_oportunities << " loop oportunities.\n";
   }
-
-  aoc::cout << "The guard visited " << visited_spaces << " cells.\n";
-  aoc::cout << "There is " << loop_oportunities << " loop oportunities.\n";
 }
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
-}
\ No newline at end of file
+static const aoc::problem problem(DAY_NAME, solve);
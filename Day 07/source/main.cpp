@@ -4,162 +4,152 @@
 
 #include "AdventOfCode.hpp"
 
-constexpr const char *const filepath = "assets/input.txt";
-
-constexpr const char *const rxs = R"(([0-9]+):[ \t]+((?: ?[0-9]+)+))";
+namespace
+{
+  using num = u64;
+  using num_list = std::vector<num>;
 
-using num = u64;
-using num_list = std::vector<num>;
+  struct equation
+  {
+    num       target = 0;
+    num_list  operands;
 
-struct equation
-{
-  num       target = 0;
-  num_list  operands;
+    equation() = default;
+    equation(const equation &) = default;
+    equation(equation &&other) = default;
+  };
+  using equation_list = std::vector<equation>;
 
-  equation() = default;
-  equation(const equation &) = default;
-  equation(equation &&other) = default;
-};
-using equation_list = std::vector<equation>;
+  // "target: operand operand ...", the operands are read as a list of integers
+  using target_pattern = aoc::pattern::seq<aoc::pattern::num<>, aoc::pattern::lit<":">>;
 
 #if 0
 #include <functional>
 
-using op = std::function<num(num, num)>;
+  using op = std::function<num(num, num)>;
 
-template<int N>
-static num evaluate_equation(const equation &eq, u32 operators)
-{
-  const op op_funcs[] = {
-    /* add */ [](num a, num b) { return a + b; },
-    /* sub */ [](num a, num b) { return a * b; },
-    /* cat */ [](num a, num b) { for (num n = b; n /= 10;) a *= 10; return (a * 10) + b; }
-  };
-
-  num result = eq.operands.front();
-  for (size_t i = 1; i < eq.operands.size(); ++i)
+  template<int N>
+  static num evaluate_equation(const equation &eq, u32 operators)
   {
-    if (result > eq.target)
-      return 0;
-
-    result = op_funcs[operators % N](result, eq.operands[i]);
-    operators /= N;
+    const op op_funcs[] = {
+      /* add */ [](num a, num b) { return a + b; },
+      /* sub */ [](num a, num b) { return a * b; },
+      /* cat */ [](num a, num b) { for (num n = b; n /= 10;) a *= 10; return (a * 10) + b; }
+    };
+
+    num result = eq.operands.front();
+    for (size_t i = 1; i < eq.operands.size(); ++i)
+    {
+      if (result > eq.target)
+        return 0;
+
+      result = op_funcs[operators % N](result, eq.operands[i]);
+      operators /= N;
+    }
+
+    return result;
   }
 
-  return result;
-}
-
-template<int N>
-static bool check_equation(const equation &eq)
-{
-  u32 max;
-  if constexpr (N == 2)
-    max = 1 << (eq.operands.size() - 1);
-  else
-    max = static_cast<u32>(std::pow(N, eq.operands.size() - 1));
-
-  for (u32 operators = 0; operators < max; ++operators)
+  template<int N>
+  static bool check_equation(const equation &eq)
   {
-    const num res = evaluate_equation<N>(eq, operators);
-    if (res == eq.target)
-      return true;
+    u32 max;
+    if constexpr (N == 2)
+      max = 1 << (eq.operands.size() - 1);
+    else
+      max = static_cast<u32>(std::pow(N, eq.operands.size() - 1));
+
+    for (u32 operators = 0; operators < max; ++operators)
+    {
+      const num res = evaluate_equation<N>(eq, operators);
+      if (res == eq.target)
+        return true;
+    }
+    return false;
   }
-  return false;
-}
 #endif
 
-// recursive variants here are both faster than iterative ones (mainly because they can early out faster).
-static bool binary_search(const equation &eq, num result, int idx)
-{
-  if (result > eq.target)
-    return false;
-
-  if (idx == eq.operands.size())
-    return result == eq.target;
+  // recursive variants here are both faster than iterative ones (mainly because they can early out faster).
+  static bool binary_search(const equation &eq, num result, int idx)
+  {
+    if (result > eq.target)
+      return false;
 
-  return binary_search(eq, result + eq.operands[idx], idx + 1) || binary_search(eq, result * eq.operands[idx], idx + 1);
-}
+    if (idx == eq.operands.size())
+      return result == eq.target;
 
-static bool ternary_search(const equation &eq, num result, int idx)
-{
-  auto concat_prep = [](num a, num b) { for (num n = b; n /= 10;) a *= 10; return (a * 10) + b; };
+    return binary_search(eq, result + eq.operands[idx], idx + 1) || binary_search(eq, result * eq.operands[idx], idx + 1);
+  }
 
-  if (result > eq.target)
-    return false;
+  static bool ternary_search(const equation &eq, num result, int idx)
+  {
+    auto concat_prep = [](num a, num b) { for (num n = b; n /= 10;) a *= 10; return (a * 10) + b; };
 
-  if (idx == eq.operands.size())
-    return result == eq.target;
+    if (result > eq.target)
+      return false;
 
-  return ternary_search(eq, result + eq.operands[idx], idx + 1) ||
-         ternary_search(eq, result * eq.operands[idx], idx + 1) ||
-         ternary_search(eq, concat_prep(result, eq.operands[idx]), idx + 1);
-}
+    if (idx == eq.operands.size())
+      return result == eq.target;
 
-static equation_list parse_input(const char *path)
-{
-  equation_list eqs;
-  equation      eq;
+    return ternary_search(eq, result + eq.operands[idx], idx + 1) ||
+           ternary_search(eq, result * eq.operands[idx], idx + 1) ||
+           ternary_search(eq, concat_prep(result, eq.operands[idx]), idx + 1);
+  }
 
-  if (!std::filesystem::exists(path))
-    throw "Input file " + std::string(path) + " does not exist";
+  static equation_list parse_input(const std::filesystem::path &path)
+  {
+    aoc::scoped_timer timer("parse");
 
-  std::ifstream ifs(path);
+    equation_list eqs;
+    equation      eq;
 
-  if (!ifs.is_open())
-    throw "Can't open input file '" + std::string(filepath) + "': " + strerror(errno);
+    const aoc::input input(path);
 
-  const std::regex rx(rxs);
+    aoc::pattern::captures<target_pattern> match;
+    for (const std::string_view line : input.lines())
+    {
+      std::string_view operands = line;
 
-  std::string line;
-  std::smatch match;
-  while (std::getline(ifs, line))
-  {
-    if (!std::regex_match(line, match, rx))
-      throw "Invalid input line: " + line;
+      eq.operands.clear();
 
-    eq.operands.clear();
+      if (!aoc::pattern::consume<target_pattern>(operands, match) || !aoc::parse::integers(operands, eq.operands))
+        throw "Invalid input line: " + std::string(line);
 
-    eq.target = std::stoull(match[1]);
-    std::stringstream ss(match[2]);
+      eq.target = match[0];
 
-    for (num operand; ss >> operand; )
-      eq.operands.emplace_back(std::move(operand));
+      eqs.emplace_back(std::move(eq));
+    }
 
-    eqs.emplace_back(std::move(eq));
+    return eqs;
   }
 
-  return eqs;
-}
-
-void solve()
-{
-  const equation_list eqs = parse_input(filepath);
-
-  std::vector<num> results(eqs.size(), 0);
-
-  std::transform(
-    std::execution::par,
-    eqs.cbegin(),
-    eqs.cend(),
-    results.begin(),
-    [](const equation &eq) { return eq.target * binary_search(eq, eq.operands[0], 1); }
-  );
-  const num binary = std::reduce(std::execution::par, results.begin(), results.end());
-
-  std::transform(
-    std::execution::par,
-    eqs.cbegin(),
-    eqs.cend(),
-    results.begin(),
-    [](const equation &eq) { return eq.target * ternary_search(eq, eq.operands[0], 1); }
-  );
-  const num ternary = std::reduce(std::execution::par, results.begin(), results.end());
-
-  aoc::cout << "Sum of solvable (A): " << binary << '\n';
-  aoc::cout << "Sum of solvable (B): " << ternary << '\n';
+  void solve(const aoc::context &ctx)
+  {
+    const equation_list eqs = parse_input(ctx.input);
+
+    aoc::scoped_timer part1("part 1");
+    const num binary = aoc::exec::transform_reduce(
+      eqs.cbegin(),
+      eqs.cend(),
+      num(0),
+      std::plus{},
+      [](const equation &eq) { return eq.target * binary_search(eq, eq.operands[0], 1); }
+    );
+    part1.stop();
+
+    aoc::scoped_timer part2("part 2");
+    const num ternary = aoc::exec::transform_reduce(
+      eqs.cbegin(),
+      eqs.cend(),
+      num(0),
+      std::plus{},
+      [](const equation &eq) { return eq.target * ternary_search(eq, eq.operands[0], 1); }
+    );
+    part2.stop();
+
+    aoc::cout << "Sum of solvable (A): " << binary << '\n';
+    aoc::cout << "Sum of solvable (B): " << ternary << '\n';
+  }
 }
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
-}
\ No newline at end of file
+static const aoc::problem problem(DAY_NAME, solve);
@@ -4,100 +4,94 @@
 
 #include "AdventOfCode.hpp"
 
-constexpr const char *const filepath = "assets/input.txt";
+namespace
+{
+  using frequency = char;
 
-using frequency = char;
+  using antenaes = std::map<frequency, std::vector<aoc::vec2>>;
 
-using antenaes = std::map<frequency, std::vector<aoc::vec2>>;
+  struct map
+  {
+    int width;
+    int height;
+    antenaes antenas;
 
-struct map
-{
-  int width;
-  int height;
-  antenaes antenas;
+    constexpr bool contains(const aoc::vec2 &pos) const
+    {
+      return pos.x >= 0 && pos.y >= 0 && pos.x < width && pos.y < height;
+    }
+  };
 
-  constexpr bool contains(const aoc::vec2 &pos) const
+  static map load_file(const std::filesystem::path &path)
   {
-    return pos.x >= 0 && pos.y >= 0 && pos.x < width && pos.y < height;
-  }
-};
+    aoc::scoped_timer timer("parse");
 
-static map load_file(const char *path)
-{
-  if (!std::filesystem::exists(path))
-    throw "Input file " + std::string(path) + " does not exist";
-
-  std::ifstream ifs(path);
+    const aoc::input input(path);
 
-  if (!ifs.is_open())
-    throw "Can't open input file '" + std::string(filepath) + "': " + strerror(errno);
+    map result;
 
-  map result;
+    size_t x;
+    result.width = 0;
+    result.height = 0;
+    for (const std::string_view line : input.lines())
+    {
+      if (result.width < line.size())
+        result.width = int(line.size());
+      else
+        assert(line.size() == result.width);
 
-  int x;
-  result.width = 0;
-  result.height = 0;
-  std::string line;
-  while (std::getline(ifs, line))
-  {
-    if (result.width < line.size())
-      result.width = int(line.size());
-    else
-      assert(line.size() == result.width);
+      for (x = 0; (x = line.find_first_not_of('.', x)) < line.size(); ++x)
+        result.antenas[line[x]].emplace_back(int(x), result.height);
 
-    while ((x = int(line.find_first_not_of("."))) < line.size())
-    {
-      result.antenas[line[x]].emplace_back(x, result.height);
-      line[x] = '.';
+      ++result.height;
     }
 
-    ++result.height;
+    return result;
   }
 
-  return result;
-}
+  void solve(const aoc::context &ctx)
+  {
+    const map map = load_file(ctx.input);
 
-void solve()
-{
-  const map map = load_file(filepath);
+    // both kinds of antinodes are found in the same pass
+    aoc::scoped_timer timer("solve");
 
-  aoc::vec2 point;
-  std::set<aoc::vec2> antinodes;
-  std::set<aoc::vec2> antinodes_ex;
-  for (const antenaes::value_type &pair : map.antenas)
-  {
-    for (int i = 0; i < pair.second.size(); ++i)
+    aoc::vec2 point;
+    aoc::bit_map antinodes(map.width, map.height);
+    aoc::bit_map antinodes_ex(map.width, map.height);
+    for (const antenaes::value_type &pair : map.antenas)
     {
-      for (int j = i + 1; j < pair.second.size(); ++j)
+      for (int i = 0; i < pair.second.size(); ++i)
       {
-        const aoc::vec2 diff = pair.second[j] - pair.second[i];
-
-        point = pair.second[j];
-        for (int l = 0; map.contains(point); ++l)
+        for (int j = i + 1; j < pair.second.size(); ++j)
         {
-          if (l == 1)
-            antinodes.insert(point);
-          antinodes_ex.insert(point);
-          point = pair.second[j] + diff * l;
-        }
-
-        point = pair.second[j];
-        for (int l = 0; map.contains(point); ++l)
-        {
-          if (l == 1)
-            antinodes.insert(point);
-          antinodes_ex.insert(point);
-          point = pair.second[i] - diff * l;
+          const aoc::vec2 diff = pair.second[j] - pair.second[i];
+
+          point = pair.second[j];
+          for (int l = 0; map.contains(point); ++l)
+          {
+            if (l == 1)
+              antinodes.set(point);
+            antinodes_ex.set(point);
+            point = pair.second[j] + diff * l;
+          }
+
+          point = pair.second[j];
+          for (int l = 0; map.contains(point); ++l)
+          {
+            if (l == 1)
+              antinodes.set(point);
+            antinodes_ex.set(point);
+            point = pair.second[i] - diff * l;
+          }
         }
       }
     }
-  }
+    timer.stop();
 
-  aoc::cout << "Antinodes: " << antinodes.size() << '\n';
-  aoc::cout << "Harmonic antinodes: " << antinodes_ex.size() << '\n';
+    aoc::cout << "Antinodes: " << antinodes.count() << '\n';
+    aoc::cout << "Harmonic antinodes: " << antinodes_ex.count() << '\n';
+  }
 }
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
-}
+static const aoc::problem problem(DAY_NAME, solve);
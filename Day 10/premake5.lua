@@ -32,6 +32,7 @@ project "Day 10"
   }
 
   defines {
+    "DAY_NAME=\"%{prj.name}\""
   }
 
   links {
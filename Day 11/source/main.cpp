@@ -4,96 +4,96 @@
 
 #include "AdventOfCode.hpp"
 
-using Stone = uint64_t;
-using List = std::vector<Stone>;
-
-constexpr const char *const filepath = "assets/input.txt";
-
-constexpr Stone odd_factor = 2024;
-
-static int num_len(size_t num)
+namespace
 {
-  int len = 1;
+  using Stone = uint64_t;
+  using List = std::vector<Stone>;
 
-  while (num / 10)
-  {
-    num /= 10;
-    ++len;
-  }
-  return len;
-};
+  constexpr Stone odd_factor = 2024;
 
-static List load_input(const char *path)
-{
-  if (!std::filesystem::exists(path))
-    throw "Input file " + std::string(path) + " does not exist";
+  static int num_len(size_t num)
+  {
+    int len = 1;
 
-  std::ifstream ifs(path);
+    while (num / 10)
+    {
+      num /= 10;
+      ++len;
+    }
+    return len;
+  };
 
-  if (!ifs.is_open())
-    throw "Can't open input file '" + std::string(filepath) + "': " + strerror(errno);
+  static List load_input(const std::filesystem::path &path)
+  {
+    aoc::scoped_timer timer("parse");
 
-  size_t n;
-  List result;
-  while (ifs >> n)
-    result.emplace_back(n);
+    const aoc::input input(path);
 
-  return result;
-}
+    List result;
+    aoc::parse::integers(input.view(), result);
 
-static aoc::cvector<Stone, 2> blink_at(const Stone &stone)
-{
-  if (stone == 0)
-    return { 1 };
+    return result;
+  }
 
-  int len = num_len(stone);
-  if (len % 2)
-    return { stone * odd_factor };
+  static aoc::cvector<Stone, 2> blink_at(const Stone &stone)
+  {
+    if (stone == 0)
+      return { 1 };
 
-  len /= 2;
+    int len = num_len(stone);
+    if (len % 2)
+      return { stone * odd_factor };
 
-  Stone left = stone;
-  size_t power = 1;
-  for (int i = 0; i < len; ++i)
-    power *= 10;
-  left /= power;
+    len /= 2;
 
-  return { left, stone - left * power };
-}
+    Stone left = stone;
+    size_t power = 1;
+    for (int i = 0; i < len; ++i)
+      power *= 10;
+    left /= power;
 
-static size_t blink(const List &stones, size_t turn)
-{
-  std::unordered_map<Stone, std::size_t> counter;
-  for (const Stone &stone : stones)
-    counter[stone] = 1;
+    return { left, stone - left * power };
+  }
 
-  std::unordered_map<Stone, std::size_t> counter_next;
-  for (size_t i = 0; i < turn; ++i)
+  static size_t blink(const List &stones, size_t turn)
   {
-    for (const auto &[stone, count] : counter)
+    std::unordered_map<Stone, std::size_t> counter;
+    for (const Stone &stone : stones)
+      counter[stone] = 1;
+
+    std::unordered_map<Stone, std::size_t> counter_next;
+    for (size_t i = 0; i < turn; ++i)
     {
-      for (const Stone &s : blink_at(stone))
-        counter_next[s] += count;
+      for (const auto &[stone, count] : counter)
+      {
+        for (const Stone &s : blink_at(stone))
+          counter_next[s] += count;
+      }
+      counter = std::move(counter_next);
+      counter_next.clear();
     }
-    counter = std::move(counter_next);
-    counter_next.clear();
+
+    size_t result = 0;
+    for (const auto &[_, count] : counter)
+      result += count;
+    return result;
   }
 
-  size_t result = 0;
-  for (const auto &[_, count] : counter)
-    result += count;
-  return result;
-}
+  void solve(const aoc::context &ctx)
+  {
+    const List stones = load_input(ctx.input);
 
-void solve()
-{
-  const List stones = load_input(filepath);
+    aoc::scoped_timer part1("part 1");
+    const size_t short_count = blink(stones, 25);
+    part1.stop();
 
-  aoc::cout << blink(stones, 25) << " stones after 25 blinks.\n";
-  aoc::cout << blink(stones, 75) << " stones after 75 blinks.\n";
-}
+    aoc::scoped_timer part2("part 2");
+    const size_t long_count = blink(stones, 75);
+    part2.stop();
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
+    aoc::cout << short_count << " stones after 25 blinks.\n";
+    aoc::cout << long_count << " stones after 75 blinks.\n";
+  }
 }
+
+static const aoc::problem problem(DAY_NAME, solve);
@@ -32,6 +32,7 @@ project "Day 13"
   }
 
   defines {
+    "DAY_NAME=\"%{prj.name}\""
   }
 
   links {
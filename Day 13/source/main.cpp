@@ -4,116 +4,119 @@
 
 #include "AdventOfCode.hpp"
 
-constexpr const char *const filepath = "assets/input.txt";
-
-struct machine
+namespace
 {
-  aoc::vec2l button_a;
-  aoc::vec2l button_b;
-  aoc::vec2l prize;
+  struct machine
+  {
+    aoc::vec2l button_a;
+    aoc::vec2l button_b;
+    aoc::vec2l prize;
+  };
 
-  friend std::istream &operator>>(std::istream &is, machine &m)
+  // Reads a "<field>: X+12, Y+34" (or "X=12, Y=34") line
+  static aoc::vec2l read_field(aoc::line_iterator &it, std::string_view field)
   {
-    aoc::vec2 tmp;
-    std::string line;
-    
-    while (std::getline(is, line) && line.empty());
-
-    if (!std::sscanf(line.c_str(), "Button A: X+%d, Y+%d", &tmp.x, &tmp.y))
-      throw std::string("Invalid input. Failed to read 'Button A' field.");
-    m.button_a = tmp;
-
-    std::getline(is, line);
-    if (!std::sscanf(line.c_str(), "Button B: X+%d, Y+%d", &tmp.x, &tmp.y))
-      throw std::string("Invalid input. Failed to read 'Button B' field.");
-    m.button_b = tmp;
-
-    std::getline(is, line);
-    if (!std::sscanf(line.c_str(), "Prize: X=%d, Y=%d", &tmp.x, &tmp.y))
-      throw std::string("Invalid input. Failed to read 'Prize' field.");
-    m.prize = tmp;
-
-    return is;
-  }
-};
+    const std::string error = "Invalid input. Failed to read '" + std::string(field) + "' field.";
 
-static std::vector<machine> load_input(const char *const path)
-{
-  if (!std::filesystem::exists(path))
-    throw "Input file " + std::string(path) + " does not exist";
+    if (it == aoc::line_iterator() || !it->starts_with(field))
+      throw error;
 
-  std::ifstream ifs(path);
+    std::string_view values = (it++)->substr(field.size());
 
-  if (!ifs.is_open())
-    throw "Can't open input file '" + std::string(filepath) + "': " + strerror(errno);
+    aoc::vec2l result;
+    if (!aoc::parse::next(values, result.x) || !aoc::parse::next(values, result.y))
+      throw error;
 
-  std::vector<machine> machines;
-  machine tmp;
-  while (ifs >> tmp)
-    machines.emplace_back(std::move(tmp));
+    return result;
+  }
 
-  return machines;
-}
+  static std::vector<machine> load_input(const std::filesystem::path &path)
+  {
+    aoc::scoped_timer timer("parse");
 
-// We have:
-//   A = the A button's offset
-//   B = the B button's offset
-//   P = the prize's position
-//
-// We are searching for the smalest (i * 3 + j) such that:
-//   i: a natural number
-//   j: a natural number
-//   iA + jB = P
-//
-// Decomposing the vectors, we end up with a system of 2 equations:
-//  | iAx + jBx = Px |
-//  | iAy + jBy = Py |
-//
-// This is solvable using Cramer's rule
-static bool solve_machine(const machine &m, u64 &iv, u64 &jv)
-{
-  const aoc::vec2l &A = m.button_a;
-  const aoc::vec2l &B = m.button_b;
-  const aoc::vec2l &P = m.prize;
+    const aoc::input input(path);
 
-  const i64 det = (A.x * B.y - B.x * A.y);
-  const i64 x = (P.x * B.y - B.x * P.y) / det;
-  const i64 y = (A.x * P.y - P.x * A.y) / det;
+    std::vector<machine> machines;
 
-  if (x < 0 || y < 0 || (A * x + B * y) != P)
-    return false;
+    const aoc::line_iterator end;
+    for (aoc::line_iterator it = input.lines().begin(); it != end;)
+    {
+      if (it->empty())
+      {
+        ++it;
+        continue;
+      }
 
-  iv = u64(x);
-  jv = u64(y);
+      machine &m = machines.emplace_back();
+      m.button_a = read_field(it, "Button A");
+      m.button_b = read_field(it, "Button B");
+      m.prize = read_field(it, "Prize");
+    }
 
-  return true;
-}
+    return machines;
+  }
 
-void solve()
-{
-  std::vector<machine> machines = load_input(filepath);
+  // We have:
+  //   A = the A button's offset
+  //   B = the B button's offset
+  //   P = the prize's position
+  //
+  // We are searching for the smalest (i * 3 + j) such that:
+  //   i: a natural number
+  //   j: a natural number
+  //   iA + jB = P
+  //
+  // Decomposing the vectors, we end up with a system of 2 equations:
+  //  | iAx + jBx = Px |
+  //  | iAy + jBy = Py |
+  //
+  // This is solvable using Cramer's rule
+  static bool solve_machine(const machine &m, u64 &iv, u64 &jv)
+  {
+    const aoc::vec2l &A = m.button_a;
+    const aoc::vec2l &B = m.button_b;
+    const aoc::vec2l &P = m.prize;
 
-  constexpr i64 part2_offset = 10'000'000'000'000;
+    const i64 det = (A.x * B.y - B.x * A.y);
+    const i64 x = (P.x * B.y - B.x * P.y) / det;
+    const i64 y = (A.x * P.y - P.x * A.y) / det;
 
-  u64 tokens_part1 = 0;
-  u64 tokens_part2 = 0;
-  for (machine &m : machines)
-  {
-    u64 i = 0;
-    u64 j = 0;
-    if (solve_machine(m, i, j))
-      tokens_part1 += (i * 3 + j);
-
-    m.prize += part2_offset;
-    if (solve_machine(m, i, j))
-      tokens_part2 += (i * 3 + j);
+    if (x < 0 || y < 0 || (A * x + B * y) != P)
+      return false;
+
+    iv = u64(x);
+    jv = u64(y);
+
+    return true;
   }
 
-  aoc::cout << "Part 1 tokens: " << tokens_part1 << '\n';
-  aoc::cout << "Part 2 tokens: " << tokens_part2 << '\n';
+  void solve(const aoc::context &ctx)
+  {
+    std::vector<machine> machines = load_input(ctx.input);
+
+    constexpr i64 part2_offset = 10'000'000'000'000;
+
+    u64 tokens_part1 = 0;
+    u64 tokens_part2 = 0;
+
+    // both parts are solved for each machine in the same pass
+    aoc::scoped_timer timer("solve");
+    for (machine &m : machines)
+    {
+      u64 i = 0;
+      u64 j = 0;
+      if (solve_machine(m, i, j))
+        tokens_part1 += (i * 3 + j);
+
+      m.prize += part2_offset;
+      if (solve_machine(m, i, j))
+        tokens_part2 += (i * 3 + j);
+    }
+    timer.stop();
+
+    aoc::cout << "Part 1 tokens: " << tokens_part1 << '\n';
+    aoc::cout << "Part 2 tokens: " << tokens_part2 << '\n';
+  }
 }
 
-void init()
-{
-  aoc::register_problem(DAY_NAME);
-}
+static const aoc::problem problem(DAY_NAME, solve);
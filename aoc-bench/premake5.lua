@@ -0,0 +1,28 @@
+-- aoc-bench (project)
+-- Microbenchmarks of the library containers against the standard ones
+project "aoc-bench"
+  kind "ConsoleApp"
+  language "C++"
+  cppdialect "C++20"
+  staticruntime "On"
+
+  targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+  objdir ("%{wks.location}/build/" .. outputdir .. "%{prj.name}")
+
+  debugdir "%{wks.location}"
+
+  files {
+    "premake5.lua",
+
+    "source/**.hpp",
+    "source/**.cpp"
+  }
+
+  includedirs {
+    "include/",
+    "source/"
+  }
+
+  links {
+    "AdventOfCode"
+  }
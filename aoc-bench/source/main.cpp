@@ -0,0 +1,434 @@
+// Advent of code 2024 - microbenchmarks of the library
+// Times the containers of the library against the standard ones, and the layouts of rect_map, on the data of the solvers
+// By: Arthur Baurens
+
+#include "flat_hash.hpp"
+#include "generate.hpp"
+#include "rect_map.hpp"
+#include "stats.hpp"
+#include "Timer.hpp"
+#include "vec.hpp"
+
+#include <set>
+#include <cmath>
+#include <array>
+#include <string>
+#include <vector>
+#include <random>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <string_view>
+#include <unordered_set>
+
+namespace
+{
+  constexpr unsigned default_runs = 7;
+  constexpr size_t   default_keys = 1 << 16;
+
+  struct options
+  {
+    std::vector<std::string> benchmarks; // all of them when empty
+    unsigned runs = default_runs;
+    size_t   size = 0; // each benchmark has its own default
+  };
+
+  struct benchmark
+  {
+    const char *name;
+    const char *description;
+    void (*run)(const options &);
+  };
+
+  // keeps the compiler from dropping the timed work
+  volatile size_t sink = 0;
+
+  // Median time of an operation over the runs, in nanoseconds
+  template<class Fn>
+  double time_per_op(const options &opts, size_t ops, Fn &&fn)
+  {
+    std::vector<double> samples;
+    samples.reserve(opts.runs);
+
+    // the first run is only a warmup
+    for (unsigned i = 0; i <= opts.runs; ++i)
+    {
+      aoc::timer timer;
+      sink = sink + fn();
+      const double nanos = timer.GetTime<double, std::nano>();
+
+      if (i > 0)
+        samples.push_back(nanos / double(ops));
+    }
+    return aoc::stats::compute(std::move(samples)).median;
+  }
+
+  // Inserts every key in an empty container, then looks up every key, then keys that are absent
+  template<class Set, class Key>
+  void bench_set(const options &opts, std::string_view keys, std::string_view container, const std::vector<Key> &present, const std::vector<Key> &absent)
+  {
+    const double insert = time_per_op(opts, present.size(), [&present]()
+    {
+      Set set;
+      for (const Key &key : present)
+        set.insert(key);
+      return set.size();
+    });
+
+    Set set(present.begin(), present.end());
+
+    const double hit = time_per_op(opts, present.size(), [&set, &present]()
+    {
+      size_t found = 0;
+      for (const Key &key : present)
+        found += set.count(key);
+      return found;
+    });
+
+    const double miss = time_per_op(opts, absent.size(), [&set, &absent]()
+    {
+      size_t found = 0;
+      for (const Key &key : absent)
+        found += set.count(key);
+      return found;
+    });
+
+    std::cout
+      << "  " << std::left << std::setw(10) << keys << std::setw(20) << container << std::right << std::fixed << std::setprecision(1)
+      << std::setw(10) << insert << std::setw(10) << hit << std::setw(10) << miss << '\n';
+  }
+
+  template<class Key>
+  void bench_sets(const options &opts, std::string_view keys, const std::vector<Key> &present, const std::vector<Key> &absent)
+  {
+    bench_set<std::set<Key>>(opts, keys, "std::set", present, absent);
+    bench_set<std::unordered_set<Key>>(opts, keys, "std::unordered_set", present, absent);
+    bench_set<aoc::flat_set<Key>>(opts, keys, "aoc::flat_set", present, absent);
+  }
+
+  // The keys of the solvers: the cells of a square region of a grid, row by row, and the nodes of a graph
+  void bench_hash(const options &opts)
+  {
+    std::mt19937_64 rng(2024);
+
+    const int side = std::max(1, int(std::sqrt(double(opts.size ? opts.size : default_keys))));
+
+    std::vector<aoc::vec2> cells;
+    std::vector<aoc::vec2> outside;
+    for (int y = 0; y < side; ++y)
+    {
+      for (int x = 0; x < side; ++x)
+      {
+        cells.push_back({ x, y });
+        outside.push_back({ x + side, y });
+      }
+    }
+    std::shuffle(outside.begin(), outside.end(), rng);
+
+    // the nodes of the graph are every other one of an array, the ones in between are looked up and missing
+    std::vector<std::array<int, 4>> nodes(cells.size() * 2);
+    std::vector<const std::array<int, 4> *> linked;
+    std::vector<const std::array<int, 4> *> unlinked;
+    for (size_t i = 0; i < nodes.size(); ++i)
+      (i % 2 ? unlinked : linked).push_back(&nodes[i]);
+    std::shuffle(linked.begin(), linked.end(), rng);
+
+    std::cout
+      << "hash: " << cells.size() << " keys, median of " << opts.runs << " runs, nanoseconds per operation\n"
+      << "  " << std::left << std::setw(10) << "keys" << std::setw(20) << "container" << std::right
+      << std::setw(10) << "insert" << std::setw(10) << "hit" << std::setw(10) << "miss" << '\n';
+
+    bench_sets(opts, "vec2", cells, outside);
+    bench_sets(opts, "pointer", linked, unlinked);
+  }
+
+  template<class Layout>
+  using char_map = aoc::rect_map<char, aoc::loader<char>, Layout>;
+
+  // Day 04: the words in the 8 directions of every 'X', the map padded by the length of the word
+  template<class Map>
+  size_t xmas_search(const Map &map)
+  {
+    constexpr aoc::vec2 dirs[] = { { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 } };
+
+    size_t found = 0;
+    for (auto it = map.begin(); it != map.end(); ++it)
+    {
+      if (*it != 'X')
+        continue;
+
+      const aoc::vec2 pos(it.pos());
+      for (const aoc::vec2 dir : dirs)
+        found += map[pos + dir] == 'M' && map[pos + dir * 2] == 'A' && map[pos + dir * 3] == 'S';
+    }
+    return found;
+  }
+
+  // Day 06: the walk of the guard from `start`, onto the padding, and at each step a second walk with an obstacle
+  // in front of it: the obstacles that make the guard walk in a loop
+  template<class Map>
+  size_t guard_walk(const Map &map, aoc::vec2 start)
+  {
+    constexpr aoc::vec2 dirs[] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+    constexpr aoc::u8 walked = 0x10;
+
+    // the directions of the second walk in each cell, `walked` for the cells of the first one
+    aoc::rect_map<aoc::u8, aoc::loader<aoc::u8>, typename Map::layout_type> marks(map.width(), map.height(), 0, 1, 0);
+    std::vector<aoc::vec2> marked;
+
+    size_t loops = 0;
+    size_t dir = 0;
+    for (aoc::vec2 pos = start; map[pos] != '\0';)
+    {
+      marks[pos] |= walked;
+
+      const aoc::vec2 next = pos + dirs[dir];
+      if (map[next] == '#')
+      {
+        dir = (dir + 1) % 4;
+        continue;
+      }
+
+      // an obstacle on a cell already walked would have changed the walk
+      if (map[next] != '\0' && !(marks[next] & walked))
+      {
+        aoc::vec2 p = pos;
+        for (size_t d = (dir + 1) % 4; map[p] != '\0';)
+        {
+          const aoc::u8 bit = aoc::u8(1 << d);
+          if (marks[p] & bit)
+          {
+            ++loops;
+            break;
+          }
+          marks[p] |= bit;
+          marked.push_back(p);
+
+          const aoc::vec2 n = p + dirs[d];
+          if (map[n] == '#' || n == next)
+            d = (d + 1) % 4;
+          else
+            p = n;
+        }
+
+        for (const aoc::vec2 m : marked)
+          marks[m] &= walked;
+        marked.clear();
+      }
+      pos = next;
+    }
+    return loops;
+  }
+
+  // Day 12: the regions of the map by flood fill, priced by area and perimeter
+  template<class Map>
+  size_t flood_fill(const Map &map)
+  {
+    constexpr aoc::vec2 dirs[] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+
+    // in the layout of the map, its padding already seen
+    aoc::rect_map<aoc::u8, aoc::loader<aoc::u8>, typename Map::layout_type> seen(map.width(), map.height(), 0, 1, 1);
+    std::vector<aoc::vec2> stack;
+
+    size_t price = 0;
+    for (auto it = map.begin(); it != map.end(); ++it)
+    {
+      const aoc::vec2 start(it.pos());
+      if (seen[start])
+        continue;
+
+      const char type = *it;
+      size_t area = 0;
+      size_t perimeter = 0;
+
+      seen[start] = 1;
+      stack.push_back(start);
+      while (!stack.empty())
+      {
+        const aoc::vec2 pos = stack.back();
+        stack.pop_back();
+        ++area;
+
+        for (const aoc::vec2 dir : dirs)
+        {
+          const aoc::vec2 next = pos + dir;
+          if (map[next] != type)
+            ++perimeter;
+          else if (!seen[next])
+          {
+            seen[next] = 1;
+            stack.push_back(next);
+          }
+        }
+      }
+      price += area * perimeter;
+    }
+    return price;
+  }
+
+  struct layout_result
+  {
+    double millis = 0;
+    size_t answer = 0;
+  };
+
+  template<class Layout, class Kernel>
+  layout_result time_layout(const options &opts, std::string_view text, size_t padding, Kernel &&kernel)
+  {
+    const char_map<Layout> map(text, padding, '\0');
+
+    layout_result result;
+    result.answer = kernel(map);
+    result.millis = time_per_op(opts, 1'000'000, [&map, &kernel]() { return kernel(map); });
+    return result;
+  }
+
+  // One kernel on a generated input, in every layout: they must all find the same answer
+  template<class Kernel>
+  void bench_kernel(const options &opts, std::string_view label, std::string_view text, size_t padding, Kernel &&kernel)
+  {
+    const layout_result results[] = {
+      time_layout<aoc::layout::row_major>(opts, text, padding, kernel),
+      time_layout<aoc::layout::tiled<8>>(opts, text, padding, kernel),
+      time_layout<aoc::layout::morton>(opts, text, padding, kernel),
+    };
+
+    std::cout << "  " << std::left << std::setw(20) << label << std::right << std::fixed << std::setprecision(2);
+    for (const layout_result &result : results)
+      std::cout << std::setw(12) << result.millis;
+    std::cout << '\n';
+
+    for (const layout_result &result : results)
+    {
+      if (result.answer != results[0].answer)
+        throw "The layouts disagree on " + std::string(label) + ": " + std::to_string(result.answer) + " instead of " + std::to_string(results[0].answer);
+    }
+  }
+
+  std::string generated_input(const char *day, size_t side)
+  {
+    const aoc::generate::generator *gen = aoc::generate::find(day);
+    if (!gen)
+      throw "No generator for " + std::string(day);
+
+    std::ostringstream out;
+    aoc::generate::write(*gen, out, side ? side : gen->default_size, aoc::generate::default_seed);
+    return out.str();
+  }
+
+  // The access patterns of the grid days, on generated inputs, in each layout of rect_map
+  void bench_layout(const options &opts)
+  {
+    const std::string day04 = generated_input("Day 04", opts.size);
+    const std::string day06 = generated_input("Day 06", opts.size);
+    const std::string day12 = generated_input("Day 12", opts.size);
+
+    const char_map<aoc::layout::row_major> grid(day12);
+    std::cout
+      << "layout: " << grid.width() << 'x' << grid.height() << " grids, median of " << opts.runs << " runs, milliseconds\n"
+      << "  " << std::left << std::setw(20) << "kernel" << std::right
+      << std::setw(12) << "row major" << std::setw(12) << "tiled 8x8" << std::setw(12) << "morton" << '\n';
+
+    bench_kernel(opts, "Day 04 xmas search", day04, 3, [](const auto &map) { return xmas_search(map); });
+    // the guard is found while parsing, like Day 06 does
+    const size_t guard = day06.find('^');
+    const size_t line = day06.find('\n') + 1;
+    const aoc::vec2 start = { int(guard % line), int(guard / line) };
+    bench_kernel(opts, "Day 06 loop checks", day06, 1, [start](const auto &map) { return guard_walk(map, start); });
+    bench_kernel(opts, "Day 12 flood fill", day12, 1, [](const auto &map) { return flood_fill(map); });
+    bench_kernel(opts, "Day 12 load", day12, 1, [&day12](const auto &map)
+    {
+      using map_type = std::decay_t<decltype(map)>;
+      return map_type(day12, 1, '\0').width();
+    });
+  }
+
+  const benchmark benchmarks[] = {
+    { "hash", "std::set and std::unordered_set against aoc::flat_set", bench_hash },
+    { "layout", "rect_map row major, in 8x8 tiles and in Z-order, on the grid days", bench_layout },
+  };
+
+  void print_usage(const char *program)
+  {
+    std::cout
+      << "Usage: " << program << " [options] [benchmark...]\n"
+      << "  Runs the benchmarks named, all of them by default.\n"
+      << "\n"
+      << "Benchmarks:\n";
+
+    for (const benchmark &bench : benchmarks)
+      std::cout << "  " << std::left << std::setw(18) << bench.name << bench.description << '\n';
+
+    std::cout
+      << "\n"
+      << "Options:\n"
+      << "  -r, --runs <n>    timed runs of each measure (default: " << default_runs << ")\n"
+      << "  -s, --size <n>    keys of hash (default: " << default_keys << "), side of the grids of layout (default: the generators')\n"
+      << "  -h, --help        display this help\n";
+  }
+
+  size_t parse_count(int ac, char **av, int &i)
+  {
+    const std::string_view arg = av[i];
+
+    if (++i >= ac)
+      throw "Missing value after " + std::string(arg);
+
+    size_t value = 0;
+    const char *end = av[i] + std::strlen(av[i]);
+    if (std::from_chars(av[i], end, value).ptr != end)
+      throw "Invalid value '" + std::string(av[i]) + "' for " + std::string(arg);
+
+    return value;
+  }
+
+  options parse_options(int ac, char **av)
+  {
+    options opts;
+
+    for (int i = 1; i < ac; ++i)
+    {
+      const std::string_view arg = av[i];
+
+      if (arg == "-h" || arg == "--help")
+      {
+        print_usage(av[0]);
+        std::exit(0);
+      }
+      else if (arg == "-r" || arg == "--runs")
+        opts.runs = unsigned(std::max<size_t>(1, parse_count(ac, av, i)));
+      else if (arg == "-s" || arg == "--size")
+        opts.size = std::max<size_t>(1, parse_count(ac, av, i));
+      else if (std::none_of(std::begin(benchmarks), std::end(benchmarks), [arg](const benchmark &bench) { return arg == bench.name; }))
+        throw "Unknown benchmark '" + std::string(arg) + "', see --help";
+      else
+        opts.benchmarks.emplace_back(arg);
+    }
+    return opts;
+  }
+}
+
+int main(int ac, char **av)
+{
+  try
+  {
+    const options opts = parse_options(ac, av);
+
+    for (const benchmark &bench : benchmarks)
+    {
+      if (opts.benchmarks.empty() || std::find(opts.benchmarks.begin(), opts.benchmarks.end(), bench.name) != opts.benchmarks.end())
+        bench.run(opts);
+    }
+  }
+  catch (std::string &err)
+  {
+    std::cerr << "Error: " << err << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
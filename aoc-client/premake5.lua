@@ -0,0 +1,28 @@
+-- aoc-client (project)
+-- Sends problems to aoc-runner --serve, measures the round trip of the requests
+project "aoc-client"
+  kind "ConsoleApp"
+  language "C++"
+  cppdialect "C++20"
+  staticruntime "On"
+
+  targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+  objdir ("%{wks.location}/build/" .. outputdir .. "%{prj.name}")
+
+  debugdir "%{wks.location}"
+
+  files {
+    "premake5.lua",
+
+    "source/**.hpp",
+    "source/**.cpp"
+  }
+
+  includedirs {
+    "include/",
+    "source/"
+  }
+
+  links {
+    "AdventOfCode"
+  }
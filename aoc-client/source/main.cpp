@@ -0,0 +1,202 @@
+// Advent of code 2024 - client of aoc-runner --serve
+// Sends a problem and its input to the server, prints the answers, or measures the round trip of the requests
+// By: Arthur Baurens
+
+#include "serve.hpp"
+#include "stats.hpp"
+#include "Timer.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <iostream>
+#include <iterator>
+#include <filesystem>
+#include <string_view>
+
+namespace
+{
+  constexpr unsigned default_warmup = 10;
+
+  struct options
+  {
+    std::filesystem::path socket = aoc::serve::default_socket;
+    std::string           problem;
+    std::filesystem::path input; // "-" for the standard input, the problem's own input by default
+
+    // latency benchmark: untimed warmup requests, then timed ones, all on the same connection
+    unsigned requests = 0;
+    unsigned warmup = default_warmup;
+  };
+
+  void print_usage(const char *program)
+  {
+    std::cout
+      << "Usage: " << program << " [options] <problem> [input]\n"
+      << "  Solves the problem (\"Day 01\", \"01\" or \"1\") on the input file (\"-\": standard input,\n"
+      << "  default: <problem>/assets/input.txt) in the server started by aoc-runner --serve <socket>.\n"
+      << "\n"
+      << "Options:\n"
+      << "  -s, --socket <s>  socket of the server (default: " << aoc::serve::default_socket << ")\n"
+      << "  -b, --bench <n>   time <n> requests on one connection, report their round trip\n"
+      << "  -w, --warmup <n>  untimed requests before benchmarking (default: " << default_warmup << ")\n"
+      << "  -h, --help        display this help\n";
+  }
+
+  unsigned parse_count(int ac, char **av, int &i)
+  {
+    const std::string_view arg = av[i];
+
+    if (++i >= ac)
+      throw "Missing value after " + std::string(arg);
+
+    unsigned value = 0;
+    const char *end = av[i] + std::strlen(av[i]);
+    if (std::from_chars(av[i], end, value).ptr != end)
+      throw "Invalid value '" + std::string(av[i]) + "' for " + std::string(arg);
+
+    return value;
+  }
+
+  options parse_options(int ac, char **av)
+  {
+    options opts;
+
+    for (int i = 1; i < ac; ++i)
+    {
+      const std::string_view arg = av[i];
+
+      if (arg == "-h" || arg == "--help")
+      {
+        print_usage(av[0]);
+        std::exit(0);
+      }
+      else if (arg == "-s" || arg == "--socket")
+      {
+        if (++i >= ac)
+          throw "Missing value after " + std::string(arg);
+        opts.socket = av[i];
+      }
+      else if (arg == "-b" || arg == "--bench")
+        opts.requests = std::max(1u, parse_count(ac, av, i));
+      else if (arg == "-w" || arg == "--warmup")
+        opts.warmup = parse_count(ac, av, i);
+      else if (opts.problem.empty())
+        opts.problem = arg;
+      else if (opts.input.empty())
+        opts.input = arg;
+      else
+        throw "Unexpected argument '" + std::string(arg) + "'";
+    }
+
+    if (opts.problem.empty())
+      throw std::string("Missing problem, see --help");
+    return opts;
+  }
+
+  // "7" -> "Day 07/assets/input.txt", like the runner
+  std::filesystem::path default_input(const std::string &problem)
+  {
+    unsigned number = 0;
+    const char *end = problem.data() + problem.size();
+    if (std::from_chars(problem.data(), end, number).ptr == end)
+      return std::filesystem::path((number < 10 ? "Day 0" : "Day ") + std::to_string(number)) / "assets" / "input.txt";
+    return std::filesystem::path(problem) / "assets" / "input.txt";
+  }
+
+  std::string read_input(const std::filesystem::path &path)
+  {
+    if (path == "-")
+      return std::string(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+      throw "Can't open input file '" + path.string() + "': " + std::strerror(errno);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  std::string format_micros(double micros)
+  {
+    std::ostringstream out;
+
+    out << std::setprecision(3);
+    if (micros < 1'000)
+      out << micros << "us";
+    else if (micros < 1'000'000)
+      out << micros / 1'000 << "ms";
+    else
+      out << micros / 1'000'000 << 's';
+    return out.str();
+  }
+
+  // Round trip of the requests, against the time the solver took in the server
+  void bench(aoc::serve::client &client, const options &opts, const std::string &input)
+  {
+    for (unsigned i = 0; i < opts.warmup; ++i)
+      client.solve(opts.problem, input);
+
+    std::vector<double> round_trips;
+    std::vector<double> solves;
+    round_trips.reserve(opts.requests);
+    solves.reserve(opts.requests);
+
+    for (unsigned i = 0; i < opts.requests; ++i)
+    {
+      aoc::timer timer;
+      const aoc::serve::response res = client.solve(opts.problem, input);
+      round_trips.push_back(timer.GetTime<double, std::micro>());
+
+      if (!res.solved)
+        throw res.text;
+      solves.push_back(res.micros);
+    }
+
+    const aoc::stats trip = aoc::stats::compute(std::move(round_trips));
+    const aoc::stats solve = aoc::stats::compute(std::move(solves));
+
+    std::cout
+      << trip.count << " requests of " << input.size() << " bytes\n"
+      << "round trip : p50 " << format_micros(trip.median) << ", p99 " << format_micros(trip.p99)
+      << ", min " << format_micros(trip.min) << ", max " << format_micros(trip.max) << '\n'
+      << "solver     : p50 " << format_micros(solve.median) << ", p99 " << format_micros(solve.p99) << '\n'
+      << "overhead   : p50 " << format_micros(trip.median - solve.median) << '\n';
+  }
+}
+
+int main(int ac, char **av)
+{
+  try
+  {
+    const options opts = parse_options(ac, av);
+    const std::string input = read_input(opts.input.empty() ? default_input(opts.problem) : opts.input);
+
+    aoc::serve::client client(opts.socket);
+
+    if (opts.requests)
+    {
+      bench(client, opts, input);
+      return 0;
+    }
+
+    aoc::timer timer;
+    const aoc::serve::response res = client.solve(opts.problem, input);
+    const double micros = timer.GetTime<double, std::micro>();
+
+    if (!res.solved)
+      throw res.text;
+
+    std::cout << res.text << "solved in " << format_micros(res.micros) << ", round trip " << format_micros(micros) << '\n';
+  }
+  catch (std::string &err)
+  {
+    std::cerr << "Error: " << err << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
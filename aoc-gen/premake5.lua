@@ -0,0 +1,29 @@
+-- aoc-gen (project)
+-- Writes scaled inputs for every day, deterministic from a seed
+project "aoc-gen"
+  kind "ConsoleApp"
+  language "C++"
+  cppdialect "C++20"
+  staticruntime "On"
+
+  targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+  objdir ("%{wks.location}/build/" .. outputdir .. "%{prj.name}")
+
+  debugdir "%{wks.location}"
+
+  files {
+    "premake5.lua",
+
+    "source/**.hpp",
+    "source/**.cpp"
+  }
+
+  includedirs {
+    "include/",
+    "source/"
+  }
+
+  -- the generators live in the library, for the runner's scaling sweeps
+  links {
+    "AdventOfCode"
+  }
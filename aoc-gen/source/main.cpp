@@ -0,0 +1,133 @@
+// Advent of code 2024 - input generator
+// Writes valid inputs of any size for every implemented day, deterministic from a seed
+// By: Arthur Baurens
+
+#include "generate.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <string_view>
+
+namespace
+{
+  using aoc::generate::generator;
+
+  struct options
+  {
+    std::vector<const generator *> days;
+    std::filesystem::path          output = "generated";
+    size_t                         size = 0; // 0: default size of each day
+    uint64_t                       seed = aoc::generate::default_seed;
+  };
+
+  void print_usage(const char *program)
+  {
+    std::cout
+      << "Usage: " << program << " [options] [problem...]\n"
+      << "  Writes an input for the given problems (\"Day 01\", \"01\" or \"1\"), or for every one of them,\n"
+      << "  as <directory>/<problem>.txt. The same seed always gives the same inputs.\n"
+      << "\n"
+      << "Options:\n"
+      << "  -o, --output <dir>  directory of the inputs (default: generated)\n"
+      << "  -n, --size <n>      size of the inputs, in the unit of each problem (default: see below)\n"
+      << "  -s, --seed <n>      seed of the inputs (default: " << aoc::generate::default_seed << ")\n"
+      << "  -h, --help          display this help\n"
+      << "\n"
+      << "Sizes:\n";
+
+    for (const generator &gen : aoc::generate::generators())
+      std::cout << "  " << gen.name << " : " << gen.default_size << ' ' << gen.unit << '\n';
+  }
+
+  template<class T>
+  T parse_number(int ac, char **av, int &i)
+  {
+    const std::string_view arg = av[i];
+
+    if (++i >= ac)
+      throw "Missing value after " + std::string(arg);
+
+    T value = 0;
+    const char *end = av[i] + std::strlen(av[i]);
+    if (std::from_chars(av[i], end, value).ptr != end)
+      throw "Invalid value '" + std::string(av[i]) + "' for " + std::string(arg);
+
+    return value;
+  }
+
+  options parse_options(int ac, char **av)
+  {
+    options opts;
+
+    for (int i = 1; i < ac; ++i)
+    {
+      const std::string_view arg = av[i];
+
+      if (arg == "-h" || arg == "--help")
+      {
+        print_usage(av[0]);
+        std::exit(0);
+      }
+      else if (arg == "-o" || arg == "--output")
+      {
+        if (++i >= ac)
+          throw "Missing value after " + std::string(arg);
+        opts.output = av[i];
+      }
+      else if (arg == "-n" || arg == "--size")
+        opts.size = parse_number<size_t>(ac, av, i);
+      else if (arg == "-s" || arg == "--seed")
+        opts.seed = parse_number<uint64_t>(ac, av, i);
+      else if (const generator *gen = aoc::generate::find(arg))
+        opts.days.push_back(gen);
+      else
+        throw "Unknown problem '" + std::string(arg) + "'";
+    }
+
+    if (opts.days.empty())
+    {
+      for (const generator &gen : aoc::generate::generators())
+        opts.days.push_back(&gen);
+    }
+    return opts;
+  }
+}
+
+int main(int ac, char **av)
+{
+  try
+  {
+    const options opts = parse_options(ac, av);
+
+    std::filesystem::create_directories(opts.output);
+
+    for (const generator *gen : opts.days)
+    {
+      const size_t size = opts.size ? opts.size : gen->default_size;
+      const std::filesystem::path path = opts.output / (std::string(gen->name) + ".txt");
+
+      std::ofstream file(path, std::ios::binary);
+      if (!file)
+        throw "Can't open '" + path.string() + "': " + std::strerror(errno);
+
+      aoc::generate::write(*gen, file, size, opts.seed);
+
+      if (!file)
+        throw "Can't write '" + path.string() + "'";
+      std::cout << path.string() << " : " << size << ' ' << gen->unit << '\n';
+    }
+  }
+  catch (std::string &err)
+  {
+    std::cerr << "Error: " << err << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
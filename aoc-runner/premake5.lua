@@ -0,0 +1,43 @@
+-- aoc-runner (project)
+-- Builds every day into a single executable, problems register themselves on startup
+project "aoc-runner"
+  kind "ConsoleApp"
+  language "C++"
+  cppdialect "C++20"
+  staticruntime "On"
+
+  targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+  objdir ("%{wks.location}/build/" .. outputdir .. "%{prj.name}")
+
+  -- inputs are looked up as "<day>/assets/input.txt"
+  debugdir "%{wks.location}"
+
+  files {
+    "premake5.lua"
+  }
+
+  for _, day in ipairs(Days) do
+    files {
+      "../" .. day .. "/source/main.cpp"
+    }
+  end
+
+  includedirs {
+    "include/",
+    "source/"
+  }
+
+  defines {
+  }
+
+  links {
+    "AdventOfCode"
+  }
+
+  -- each day's sources keep their own DAY_NAME
+  for _, day in ipairs(Days) do
+    filter("files:../" .. day .. "/**")
+      defines {
+        "DAY_NAME=\"" .. day .. "\""
+      }
+  end